@@ -49,7 +49,8 @@ MAK_INCL=$(MEN_INC_DIR)/m47_drv.h	\
          $(MEN_INC_DIR)/ll_defs.h	\
          $(MEN_INC_DIR)/ll_entry.h	\
          $(MEN_INC_DIR)/dbg.h		\
-         $(MEN_MOD_DIR)/m47_flex.h
+         $(MEN_MOD_DIR)/m47_flexz.h	\
+         $(MEN_MOD_DIR)/m47_flexld.h
 
 MAK_INP1=m47_drv$(INP_SUFFIX)
 MAK_INP2=
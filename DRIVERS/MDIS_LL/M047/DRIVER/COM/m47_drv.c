@@ -15,12 +15,25 @@
  *               
  *               The directions of the channels cannot be altered.
  *
- *               Usage of interrupts is not implemented in this driver.
+ *               Optionally an OSS alarm samples all enabled channels
+ *               periodically into per-channel ring buffers, which are
+ *               drained by M47_BlockRead in M47_BLKRD_FIFO mode.
+ *
+ *               The M47 has no documented interrupt enable, so the
+ *               driver requests no interrupt and the hardware is always
+ *               polled. An OSS alarm can simulate a frame-complete
+ *               interrupt (descriptor key IRQ_SIM_PERIOD); the alarm then
+ *               captures all enabled channels into the same ring buffers
+ *               and wakes up waiting readers.
  *               
  *               
  *
  *     Required: OSS, DESC, DBG, ID libraries 
  *     Switches: _ONE_NAMESPACE_PER_DRIVER_
+ *               M47_FAST   production build (driver_fast.mak):
+ *                          no debug output in M47_Read, M47_BlockRead
+ *                          and M47_GetStat, data words read inline with
+ *                          folded register offsets (M47_FAST_DATA)
  *
  *
  *---------------------------------------------------------------------------
@@ -54,13 +67,14 @@
 #include <MEN/mdis_com.h>   /* MDIS common defs               */
 #include <MEN/mdis_err.h>   /* MDIS error codes               */
 #include <MEN/ll_defs.h>    /* low-level driver definitions   */
-#include "m47_flex.h"       /* flex array */
+#include "m47_flexz.h"      /* compressed flex data */
 
 /*-----------------------------------------+
 |  DEFINES                                 |
 +-----------------------------------------*/
 /* general */
 #define CH_NUMBER           4           /* number of device channels */
+#define CH_MASK_ALL         0x0f        /* M47_READ_MASK: all channels */
 #define USE_IRQ             FALSE       /* interrupt required  */
 #define ADDRSPACE_COUNT     1           /* nr of required address spaces */
 #define ADDRSPACE_SIZE      256         /* size of address space */
@@ -73,6 +87,29 @@
 #define MODE_DEFAULT        0x00000000  /* default value of transmission mode: Gray encoding */
 
 #define HW_MAJOR_REV_2      0x0200      /* HW major revision 2 */
+#define SSI_TMONO_US        20          /* SSI monoflop time [us] (approx.) */
+
+#define TEAR_RETRY_MAX      3           /* max. re-reads of a torn data word */
+#define GLITCH_RUN_MAX      3           /* rejections in a row before resync */
+
+#define FLEX_LOAD_AUTO      0           /* FLEX_LOAD: load if PLD rev differs */
+#define FLEX_LOAD_FORCE     1           /* FLEX_LOAD: always load (default) */
+#define FLEX_LOAD_SKIP      2           /* FLEX_LOAD: never load */
+#define FLEX_CHUNK_CYCLES   128         /* JTAG cycles per INIT_DEFERRED alarm */
+#define INIT_ALARM_MS       1           /* INIT_DEFERRED alarm period [ms] */
+
+#define CONNECT_PROBE_MS    4           /* max. M47_CHECK_CONNECT probe time [ms] */
+#define VECTOR_POLL_US      10          /* M47_BLKRD_VECTOR frame poll step [us] */
+#define VALID_TIMEOUT_DEFAULT 100       /* default M47_WAIT_VALID timeout [ms] */
+
+#define SHADOW_UNKNOWN      0xffff      /* register shadow: hw state unknown */
+
+#define MOTION_HIST         16          /* motion history entries per channel */
+#define MOTION_WINDOW_DEFAULT 4         /* default motion filter window */
+#define INT64_SAT           ((int64)(~(u_int64)0 >> 1)) /* max. int64 */
+
+#define SAMPLE_DEPTH_DEFAULT 64         /* default ring buffer depth [samples] */
+#define SAMPLE_DEPTH_MAX    0x10000     /* max. ring buffer depth [samples] */
 
 /* debug settings */
 #define DBG_MYLEVEL         llHdl->dbgLevel
@@ -92,16 +129,42 @@
 
 #define FLEXREG             0xde        /* offset for flex load */
 #define STATUS_REG          0xa0        /* Status Register offset */
+#define STATUS_TRANSFER     0x000f      /* Status Register: transfer bits TA..TD */
 #define REG_START           0x00        /* Data Register offset for channel */
 #define DATACH(ch)          ((ch) << 3) /* register offset for single channels */
 /*
 #define DATACH(ch)          ((ch * 8) + 1)
 */
 
-/* single bit setting macros used by m47_flexload */
-#define bitset(byte,mask)  ((byte) |=  (mask))
-#define bitclr(byte,mask)  ((byte) &= ~(mask))
-#define bitmove(byte,mask,bool) (bool ? bitset(byte,mask) : bitclr(byte,mask))
+/*
+ * Register access counted in busAcc for M47_BLK_INITSTAT. Used by the
+ * init and reconfiguration code; the data read paths access the
+ * registers with MREAD_D16 directly.
+ */
+#define M47_RD16(h,offs)     ((h)->busAcc++, MREAD_D16((h)->ma, offs))
+#define M47_WR16(h,offs,val) ((h)->busAcc++, MWRITE_D16((h)->ma, offs, val))
+
+#ifdef M47_FAST
+/*
+ * Data word of channel ch with nBytes valid bytes, most significant byte
+ * first like M47_ReadDxx. For a constant ch, the register offsets are
+ * folded at compile time. No tear check and no Gray decoding.
+ */
+#define M47_FAST_DATA(ma,ch,nBytes,data) \
+    do { \
+        (data) = 0; \
+        if ((nBytes) > 3) \
+            (data)  = (u_int32)(u_int8)MREAD_D16((ma), DATACH(ch)) << 24; \
+        if ((nBytes) > 2) \
+            (data) |= (u_int32)(u_int8)MREAD_D16((ma), DATACH(ch) + 0x02) << 16; \
+        if ((nBytes) > 1) \
+            (data) |= (u_int32)(u_int8)MREAD_D16((ma), DATACH(ch) + 0x04) << 8; \
+        if ((nBytes) > 0) \
+            (data) |= (u_int32)(u_int8)MREAD_D16((ma), DATACH(ch) + 0x06); \
+    } while (0)
+#endif /* M47_FAST */
+
+#include "m47_flexld.h"     /* flex loader (needs FLEXREG) */
 
 
 /*-----------------------------------------+
@@ -115,8 +178,42 @@ typedef struct {
     u_int16         transMode;      /* transmission mode = sensor encoding (Gray or binary) */
 } M47_OPTIONS;
 
-/* low-level handle */
+/* data word reader (see M47_SelectReaders) */
+typedef u_int32 (*M47_READER)( MACCESS ma, int32 ch );
+
+/* ring buffer entry */
+typedef struct {
+    u_int64         stamp;          /* time of acquisition [us] */
+    u_int32         age;            /* estimated data age at stamp [us] */
+    u_int32         seq;            /* per-channel sequence number */
+    u_int32         value;          /* SSI data word */
+} M47_RING_ENT;
+
+/* motion history entry */
+typedef struct {
+    int64           pos;            /* continuous position */
+    int64           vel;            /* velocity at stamp */
+    u_int64         stamp;          /* time [us] */
+} M47_HIST_ENT;
+
+/* per-channel sample ring buffer */
 typedef struct {
+    M47_RING_ENT    *buf;           /* sample buffer (sampleDepth entries) */
+    u_int32         rdIdx;          /* index of oldest sample */
+    u_int32         wrIdx;          /* index of next free entry */
+    u_int32         count;          /* number of buffered samples */
+    u_int32         seq;            /* sequence number of next sample */
+    u_int32         overrun;        /* number of overwritten samples */
+} M47_RING;
+
+/* low-level handle (defined after the includes that need its name) */
+typedef struct M47_LL_HANDLE LL_HANDLE;
+
+/* include files which need LL_HANDLE */
+#include <MEN/ll_entry.h>  /* low-level driver jump table  */
+#include <MEN/m47_drv.h>   /* M47 driver header file */
+
+struct M47_LL_HANDLE {
     /* general */
     int32           memAlloc;       /* size allocated for the handle */
     OSS_HANDLE      *osHdl;         /* oss handle */
@@ -129,23 +226,108 @@ typedef struct {
     DBG_HANDLE      *dbgHdl;        /* debug handle */
     /* misc */
     u_int32         irqCount;       /* interrupt counter */
+    u_int32         irqEnabled;     /* frame-complete interrupt enabled */
+    u_int32         irqSimPeriod;   /* simulated interrupt period [ms], 0=off */
+    OSS_ALARM_HANDLE *irqSimAlarmHdl;       /* simulated interrupt source */
+    OSS_SEM_HANDLE  *devSemHdl;     /* device semaphore handle */
+    OSS_SEM_HANDLE  *readSemHdl[CH_NUMBER]; /* wakes up waiting readers */
+    u_int32         readTimeout;    /* M47_BLKRD_FIFO read timeout [ms] */
+    u_int32         readWait;       /* channel mask of waiting readers */
     u_int32         idCheck;        /* id check enabled */
     M47_OPTIONS     options[CH_NUMBER];     /* structure of M47 driver options */
+    M47_READER      reader[CH_NUMBER];      /* data word reader per channel */
+    u_int32         dataBytes[CH_NUMBER];   /* valid data bytes per channel */
+    u_int32         widthMask[CH_NUMBER];   /* valid data bits per channel */
+    u_int32         swGray[CH_NUMBER];      /* Gray decoding in software */
+    u_int16         contShadow[CH_NUMBER];  /* last CONTREG_CHx write */
+    u_int16         modeShadow[CH_NUMBER];  /* last MODE_REV_CHx write */
+    u_int32         consistRead;    /* torn data words are re-read */
+    u_int32         tearCount[CH_NUMBER];   /* torn data words per channel */
+    /* multi-turn unwrapping */
+    int64           pos[CH_NUMBER];         /* continuous position */
+    u_int32         posRaw[CH_NUMBER];      /* last data word */
+    u_int32         posValid[CH_NUMBER];    /* posRaw valid */
+    /* glitch filter */
+    u_int32         glitchLimit[CH_NUMBER]; /* max. velocity [counts/s], 0=off */
+    u_int64         glitchStamp[CH_NUMBER]; /* time of last good data word */
+    u_int32         glitchRun[CH_NUMBER];   /* rejections in a row */
+    u_int32         glitchCount[CH_NUMBER]; /* rejected data words */
+    /* motion estimation */
+    u_int32         motionWin;      /* filter window [samples] */
+    M47_HIST_ENT    hist[CH_NUMBER][MOTION_HIST];   /* motion history */
+    u_int32         histIdx[CH_NUMBER];     /* index of newest entry */
+    u_int32         histCnt[CH_NUMBER];     /* number of entries */
+    int64           vel[CH_NUMBER]; /* velocity [1/2^M47_MOTION_FRAC counts/s] */
+    int64           acc[CH_NUMBER]; /* acceleration [1/2^M47_MOTION_FRAC counts/s^2] */
+    u_int16         idProm[MOD_ID_SIZE/2];  /* ID PROM copy read at init */
     u_int16         moduleHwRev;            /* HW Revision from Module EEPROM */
-} LL_HANDLE;
+    u_int32         flexHash;       /* hash of loaded bitstream, 0=unknown */
+    u_int32         flexLoads;      /* M47_BLK_FLEXLOAD loads done */
+    /* deferred init */
+    OSS_ALARM_HANDLE *initAlarmHdl; /* deferred flex load alarm handle */
+    M47_FLEXZ_STATE flexState;      /* deferred flex load progress */
+    volatile u_int32 ready;         /* hardware initialized */
+    volatile u_int32 initLoaded;    /* deferred load done, regs not set */
+    /* init statistics */
+    u_int32         initUs[M47_INIT_PHASES];    /* phase durations [us] */
+    u_int32         initAcc[M47_INIT_PHASES];   /* phase register accesses */
+    u_int32         initDeferred;   /* FLEX/HW phases done by alarm */
+    u_int32         busAcc;         /* counted register accesses */
+    u_int64         initT0;         /* deferred init: start of phase [us] */
+    u_int32         initAcc0;       /* deferred init: busAcc at phase start */
+    u_int32         blkRdMode;      /* M_getblock mode (M47_BLKRD_xxx) */
+    u_int32         readMask;       /* M47_BLKRD_VECTOR channels */
+    u_int32         vecSeen;        /* transfer bits since last vector sample */
+    u_int32         vecSeq;         /* vector sample counter */
+    /* background sampling */
+    OSS_ALARM_HANDLE *alarmHdl;     /* sampling alarm handle */
+    OSS_SPINL_HANDLE *lockHdl;      /* protects the ring buffers */
+    u_int32         samplePeriod;   /* real sampling period [ms], 0=off */
+    /* connection monitoring */
+    OSS_ALARM_HANDLE *connAlarmHdl; /* connection monitor alarm handle */
+    u_int32         connPeriod;     /* real monitor period [ms], 0=off */
+    u_int32         connMask;       /* cached transfer bits TA..TD */
+    u_int32         connSeen;       /* transfer bits cleared by other paths */
+    u_int32         connValid;      /* connMask valid */
+    u_int64         connStamp;      /* time of connMask update [us] */
+    /* data valid detection */
+    u_int32         cfgGen[CH_NUMBER];      /* configuration generation */
+    u_int32         frameSeen;      /* transfer bits since last reconfig */
+    u_int32         skipMask;       /* next transfer bit is from old mode */
+    u_int32         validMask;      /* channels with valid data */
+    u_int32         validTimeout;   /* M47_WAIT_VALID timeout [ms] */
+    /* sample flags */
+    u_int32         freshSeen;      /* transfer bits since last flagged read */
+    u_int64         frameStamp[CH_NUMBER];  /* time a frame was last seen [us] */
+    u_int32         sampleDepth;    /* ring buffer depth [samples] */
+    M47_RING_ENT    *ringMem;       /* ring buffer memory */
+    u_int32         ringAlloc;      /* size allocated for ring buffers */
+    M47_RING        ring[CH_NUMBER];        /* per-channel ring buffers */
+    /* time base */
+    u_int32         usPerTick;      /* microseconds per system tick */
+    u_int32         tickLast;       /* last system tick read */
+    u_int32         tickHigh;       /* system tick wrap counter */
+};
 
     
 
-/* include files which need LL_HANDLE */
-#include <MEN/ll_entry.h>  /* low-level driver jump table  */
-#include <MEN/m47_drv.h>   /* M47 driver header file */
-
 static const char IdentString[]=MENT_XSTR(MAK_REVISION);
 
+/* per-channel register offsets */
+static const u_int16 M47_ContReg[CH_NUMBER] =
+    { CONTREG_CH0, CONTREG_CH1, CONTREG_CH2, CONTREG_CH3 };
+static const u_int16 M47_ModeReg[CH_NUMBER] =
+    { MODE_REV_CH0, MODE_REV_CH1, MODE_REV_CH2, MODE_REV_CH3 };
+
 /*-----------------------------------------+
 |  PROTOTYPES                              |
 +-----------------------------------------*/
 static int32 m47_flexload ( LL_HANDLE *llHdl );
+static void M47_InitHw( LL_HANDLE *llHdl );
+static void M47_InitAlarm( void *arg );
+static int32 M47_InitFinish( LL_HANDLE *llHdl );
+static void M47_InitPhase( LL_HANDLE *llHdl, int32 phase,
+                           u_int64 *t0P, u_int32 *acc0P );
 static int32 M47_Init(DESC_SPEC *descSpec, OSS_HANDLE *osHdl,
                        MACCESS *ma, OSS_SEM_HANDLE *devSemHdl,
                        OSS_IRQ_HANDLE *irqHdl, LL_HANDLE **llHdlP);
@@ -164,12 +346,60 @@ static int32 M47_Info(int32 infoType, ... );
 static char* Ident( void );
 static int32 Cleanup(LL_HANDLE *llHdl, int32 retCode);
 static char* M47_FlexDataIdent( void );
-static void M47_UpdateControlRegs( LL_HANDLE *llHdl );
+static u_int32 M47_FlexPldRev( void );
+static int32 M47_FlexLoadBlob( LL_HANDLE *llHdl, M_SG_BLOCK *blk );
+static void M47_Reconfig( LL_HANDLE *llHdl );
+static void M47_WriteShadow( LL_HANDLE *llHdl, u_int32 offs,
+                             u_int16 *shadow, u_int16 val );
+static u_int32 M47_ReadData( LL_HANDLE *llHdl, int32 ch );
+static void M47_SelectReaders( LL_HANDLE *llHdl );
+static u_int32 M47_ReadD0( MACCESS ma, int32 ch );
+static u_int32 M47_ReadD8( MACCESS ma, int32 ch );
+static u_int32 M47_ReadD16( MACCESS ma, int32 ch );
+static u_int32 M47_ReadD24( MACCESS ma, int32 ch );
+static u_int32 M47_ReadD32( MACCESS ma, int32 ch );
+static u_int32 M47_ReadUpper( MACCESS ma, int32 ch, u_int32 nBytes );
+static void M47_Snapshot( LL_HANDLE *llHdl, M47_SNAPSHOT *snap );
+static void M47_FlaggedRead( LL_HANDLE *llHdl, M47_FSAMPLE *smp );
+static int32 M47_VectorRead( LL_HANDLE *llHdl, u_int32 *buf, int32 size,
+                             int32 *nbrRdBytesP );
+static u_int32 M47_VectorSeen( LL_HANDLE *llHdl, u_int32 clear );
+static void M47_ModeRegs( LL_HANDLE *llHdl, u_int16 *mode );
+static u_int32 M47_GrayDecode( u_int32 data, u_int32 mask );
+static void M47_Unwrap( LL_HANDLE *llHdl, int32 ch, u_int32 data );
+static int32 M47_Glitch( LL_HANDLE *llHdl, int32 ch, int32 delta );
+static void M47_UnwrapReset( LL_HANDLE *llHdl, int32 ch );
+static void M47_Motion( LL_HANDLE *llHdl, int32 ch );
+static int64 M47_Div64( int64 num, u_int32 den );
+static int64 M47_MulDiv( int64 num, u_int32 mul, u_int32 den );
+static int32 M47_Sat32( int64 val );
+static int32 M47_SampleStart( LL_HANDLE *llHdl, u_int32 period );
+static void M47_SampleAlarm( void *arg );
+static void M47_Acquire( LL_HANDLE *llHdl );
+static int32 M47_IrqEnable( LL_HANDLE *llHdl, u_int32 enable );
+static void M47_IrqSimAlarm( void *arg );
+static int32 M47_FifoRead( LL_HANDLE *llHdl, int32 ch, void *buf,
+                           int32 size, int32 *nbrRdBytesP );
+static u_int64 M47_TimeUs( LL_HANDLE *llHdl );
+static u_int32 M47_FrameTimeUs( LL_HANDLE *llHdl, int32 ch );
+static int32 M47_ConnectStart( LL_HANDLE *llHdl, u_int32 period );
+static void M47_ConnectAlarm( void *arg );
+static u_int32 M47_ConnectProbe( LL_HANDLE *llHdl );
+static void M47_ValidReset( LL_HANDLE *llHdl, u_int32 chMask,
+                            u_int32 running );
+static void M47_FrameSeen( LL_HANDLE *llHdl, u_int32 bits );
+static int32 M47_WaitValid( LL_HANDLE *llHdl, int32 ch, u_int32 *genP );
+static int32 M47_ApplyConfig( LL_HANDLE *llHdl, M47_CONFIG *cfg );
 
 /******************************** m47_flexload *******************************
  *
  *  Description:  Load FLEXlogic (JTAG interface) with binary data.
  *
+ *                The bitstream is stored compressed (m47_flexz.h) and
+ *                shifted in by M47_FlexLoadZ() (m47_flexld.h). The JTAG
+ *                waveform is identical to the one of the uncompressed
+ *                m47_flex.h data, see m47_flexsim.
+ *
  *---------------------------------------------------------------------------
  *  Input......:  llHdl    low-level handle
  *  Output.....:  return   0
@@ -182,50 +412,162 @@ static int32 m47_flexload
     
 )
 {
-   u_int8  ctrl,                   /* control word */
-           ch, n;                  /* current byte */
-   u_int8  tdo;
-   u_int8  tck;
-   u_int8  tms;
-   u_int8  *p = (u_int8*)M47_FlexData;     /* point to binary data */
-   u_int32 size;                           /* size of binary data */
-
    DBGWRT_1((DBH, "LL - m47_flexload\n"));
 
-   size  = (u_int32)(*p++) << 24;   /* get data size */
-   size |= (u_int32)(*p++) << 16;
-   size |= (u_int32)(*p++) <<  8;
-   size |= (u_int32)(*p++);
+   M47_FlexLoadZStart( &llHdl->flexState );
+   M47_FlexLoadZ( llHdl->ma, &llHdl->flexState, M47_FLEXZ_CYCLES );
+   llHdl->busAcc += 3 * M47_FLEXZ_CYCLES;
+
+   return(0);
+}
+
+/******************************** M47_InitHw ********************************
+ *
+ *  Description:  Program the registers of a loaded PLD.
+ *
+ *                Stops all channels, clears the data RAM and sets mode
+ *                and control registers from the channel options. Then
+ *                the device is ready.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl    low-level handle
+ *  Output.....:  -
+ *  Globals....:  ---
+ ****************************************************************************/
+static void M47_InitHw( LL_HANDLE *llHdl ) /* nodoc */
+{
+    int32 i;
+
+    DBGWRT_2((DBH, "LL - Mode/PLD Revision Register = %04X\n", 
+    M47_RD16( llHdl, MODE_REV_CH0)));
+
+    /* hw state unknown: every channel is stopped and reprogrammed */
+    for (i = 0; i < CH_NUMBER; i++)
+        llHdl->contShadow[i] = llHdl->modeShadow[i] = SHADOW_UNKNOWN;
+
+    M47_Reconfig( llHdl );
 
-   tdo = 1 << 0;         /* convert bits to bitmask */
-   tck = 1 << 1;
-   tms = 1 << 2;
+    DBGWRT_2((DBH, "LL - Registers set\n"));
+    for (i = 0; i < CH_NUMBER; i++)
+        DBGWRT_2((DBH, " CONTREG_CH%d  = %04X  MODE_REV_CH%d = %04X\n",
+                  i, llHdl->contShadow[i], i, llHdl->modeShadow[i]));
 
-   ctrl = 0x00;            /* control word initial value */
+    llHdl->ready = TRUE;
+}
 
-   while(size--)           /* for all bytes */
-   {
-      ch = *p++;              /* get next data byte */
-      n = 4;                  /* data byte: 4*2 bit */
+/******************************* M47_InitAlarm ******************************
+ *
+ *  Description:  Alarm routine for INIT_DEFERRED.
+ *
+ *                Shifts the next FLEX_CHUNK_CYCLES of the bitstream into
+ *                the PLD. After the last chunk, the alarm marks the load
+ *                done and stops itself. The registers are programmed by
+ *                the next call on the device (M47_InitFinish), not here.
+ *
+ *                Cost per alarm in alarm context: 3 * FLEX_CHUNK_CYCLES
+ *                (384) register writes, about 0.4 ms at 1 us per M-Module
+ *                access. The built-in bitstream takes M47_FLEXZ_CYCLES /
+ *                FLEX_CHUNK_CYCLES (254) alarms.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  arg      low-level handle
+ *  Output.....:  -
+ *  Globals....:  ---
+ ****************************************************************************/
+static void M47_InitAlarm( void *arg ) /* nodoc */
+{
+    LL_HANDLE *llHdl = (LL_HANDLE*)arg;
+    u_int32   done;
+    int32     complete;
 
-      while(n--)                 /* write data 2 bits */
-      {
+    if (llHdl->ready || llHdl->initLoaded)
+        return;
 
-         bitclr (ctrl,tck);                 /* clear TCK */
-         MWRITE_D16( llHdl->ma, FLEXREG, ctrl );
+    done = llHdl->flexState.n;
+    complete = M47_FlexLoadZ( llHdl->ma, &llHdl->flexState,
+                              FLEX_CHUNK_CYCLES );
+    llHdl->busAcc += 3 * (llHdl->flexState.n - done);
 
-         bitmove(ctrl,tdo,ch & 0x01);       /* write TDO/TMS bits */
-         bitmove(ctrl,tms,ch & 0x02);
-         MWRITE_D16( llHdl->ma, FLEXREG, ctrl );
+    if (!complete)
+        return;
 
-         bitset (ctrl,tck);                 /* set TCK (pulse) */
-         MWRITE_D16( llHdl->ma, FLEXREG, ctrl );
+    llHdl->flexHash = M47_FLEXZ_HASH;
+    DBGWRT_2((DBH, "LL - Flex loaded (deferred)\n"));
+    M47_InitPhase( llHdl, M47_INIT_FLEX, &llHdl->initT0, &llHdl->initAcc0 );
 
-         ch >>= 2;
-      }
-   }
+    llHdl->initLoaded = TRUE;
+    OSS_AlarmClear( llHdl->osHdl, llHdl->initAlarmHdl );
+}
 
-   return(0);
+/******************************* M47_InitFinish *****************************
+ *
+ *  Description:  Program the registers after an INIT_DEFERRED load.
+ *
+ *                Called by M47_Read, M47_BlockRead, M47_SetStat and
+ *                M47_GetStat while the device is not ready. Once the
+ *                alarm has loaded the bitstream, the first such call
+ *                runs M47_InitHw (in its own context) and records the
+ *                HW phase.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl    low-level handle
+ *  Output.....:  return   device ready (TRUE/FALSE)
+ *  Globals....:  ---
+ ****************************************************************************/
+static int32 M47_InitFinish( LL_HANDLE *llHdl ) /* nodoc */
+{
+    if (llHdl->ready || !llHdl->initLoaded)
+        return(llHdl->ready);
+
+    /* HW phase starts now, not when the alarm finished */
+    OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+    llHdl->initT0 = M47_TimeUs( llHdl );
+    OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+    llHdl->initAcc0 = llHdl->busAcc;
+
+    M47_InitHw( llHdl );
+    M47_InitPhase( llHdl, M47_INIT_HW, &llHdl->initT0, &llHdl->initAcc0 );
+
+    return(llHdl->ready);
+}
+
+/******************************* M47_InitPhase ******************************
+ *
+ *  Description:  Record the duration and register accesses of an init
+ *                phase (M47_BLK_INITSTAT) and start the next one.
+ *
+ *                The duration has system tick resolution.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl    low-level handle
+ *                phase    finished phase (M47_INIT_xxx)
+ *                t0P      start time of phase [us]
+ *                acc0P    busAcc at start of phase
+ *  Output.....:  t0P      start time of next phase [us]
+ *                acc0P    busAcc at start of next phase
+ *  Globals....:  ---
+ ****************************************************************************/
+static void M47_InitPhase(
+    LL_HANDLE *llHdl,
+    int32 phase,
+    u_int64 *t0P,
+    u_int32 *acc0P
+) /* nodoc */
+{
+    u_int64 now;
+
+    OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+    now = M47_TimeUs( llHdl );
+    OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+
+    llHdl->initUs[phase]  = (u_int32)(now - *t0P);
+    llHdl->initAcc[phase] = llHdl->busAcc - *acc0P;
+
+    DBGWRT_2((DBH, "LL - init phase %d: %d us, %d accesses\n", phase,
+              llHdl->initUs[phase], llHdl->initAcc[phase]));
+
+    *t0P   = now;
+    *acc0P = llHdl->busAcc;
 }
 
 /**************************** M47_GetEntry *********************************
@@ -241,7 +583,11 @@ static int32 m47_flexload
     extern void LL_GetEntry( LL_ENTRY* drvP )
 #else
 # ifndef MAC_BYTESWAP
+#  ifndef M47_FAST
     extern void M47_GetEntry( LL_ENTRY* drvP )
+#  else
+    extern void M47_FAST_GetEntry( LL_ENTRY* drvP )
+#  endif /* M47_FAST */
 # else
     extern void M47_SW_GetEntry( LL_ENTRY* drvP )
 # endif /* MAC_BYTESWAP */
@@ -265,7 +611,7 @@ static int32 m47_flexload
  * 
  *                The function initializes all channels with the 
  *                definitions made in the descriptor. The interrupt 
- *                is always disabled.
+ *                is disabled (see M_MK_IRQ_ENABLE).
  *
  *                The following descriptor keys are used:
  *
@@ -277,6 +623,62 @@ static int32 m47_flexload
  *                M47_CONTROL           0x00000080       see below
  *                M47_TRANSMODE         0x00000000       0x00000000 (Gray)
  *                                                       0x00000080 (binary)
+ *                SAMPLE_PERIOD         0                0..max [ms]
+ *                SAMPLE_DEPTH          64               0..65536
+ *                READ_TIMEOUT          0                0..max [ms]
+ *                IRQ_SIM_PERIOD        0                0..max [ms]
+ *                MOTION_WINDOW         4                1..15
+ *                CONNECT_PERIOD        0                0..max [ms]
+ *                FLEX_LOAD             1                0..2
+ *                INIT_DEFERRED         0                0..1
+ *                CHANNEL_n/M47_CONTROL    M47_CONTROL   see below
+ *                CHANNEL_n/M47_TRANSMODE  M47_TRANSMODE see M47_TRANSMODE
+ *                CHANNEL_n/GLITCH_LIMIT   0             0..max [counts/s]
+ *
+ *                CHANNEL_n/M47_CONTROL and CHANNEL_n/M47_TRANSMODE set
+ *                    channel n (0..3) and default to the global keys.
+ *                    All channels are programmed in one pass, so they
+ *                    deliver data in their final configuration after
+ *                    M47_Init. Below HW revision 2.0, only
+ *                    M47_TRANSMODE may differ between the channels.
+ *
+ *                CHANNEL_n/GLITCH_LIMIT enables the glitch filter of
+ *                    channel n (0 = off), see M47_GLITCH_LIMIT. It only
+ *                    filters the continuous position and motion values.
+ *
+ *                SAMPLE_PERIOD starts background sampling of all enabled
+ *                    channels with the given period (0 = off).
+ *
+ *                SAMPLE_DEPTH defines the number of samples each
+ *                    channel's ring buffer can hold (0 = no buffers,
+ *                    background sampling not available).
+ *
+ *                READ_TIMEOUT defines how long M47_BlockRead waits in
+ *                    M47_BLKRD_FIFO mode for a sample (0 = don't wait).
+ *
+ *                IRQ_SIM_PERIOD simulates the frame-complete interrupt
+ *                    by an OSS alarm with the given period (0 = no
+ *                    interrupt, M_MK_IRQ_ENABLE fails).
+ *
+ *                MOTION_WINDOW sets the number of position differences
+ *                    averaged for M47_VELOCITY and M47_ACCEL.
+ *
+ *                CONNECT_PERIOD starts the connection monitor with the
+ *                    given period (0 = M47_CHECK_CONNECT probes).
+ *
+ *                FLEX_LOAD controls loading of the PLD bitstream:
+ *                    0 = load only if the PLD revision differs from
+ *                        the built-in bitstream
+ *                    1 = always load
+ *                    2 = never load
+ *
+ *                INIT_DEFERRED returns from M47_Init before the
+ *                    bitstream is loaded. The load is done by an alarm
+ *                    in chunks of 128 JTAG cycles (384 register writes
+ *                    per alarm). The first read or status call after
+ *                    the load programs the registers. Until then, reads
+ *                    and most status calls fail with ERR_LL_DEV_NOTRDY.
+ *                    The module ID is still checked synchronously.
  *
  *                M47_CONTROL sets the baud rate and number of bits in
  *                    a data word:
@@ -320,14 +722,17 @@ static int32 M47_Init(
     u_int32 gotsize;
     int32 error;
     u_int32 value;
-    u_int16 count;
-    u_int16 n;          /* count for data buffer clearing */
     u_int32 contReg;    /* control register entry read from descriptor */
     u_int32 modeReg;    /* mode register entry read from descriptor */
+    u_int32 period;     /* sampling period read from descriptor */
+    u_int32 connPeriod; /* connection monitor period read from descriptor */
+    u_int32 flexLoad;   /* FLEX_LOAD mode read from descriptor */
+    u_int32 pldRev;     /* PLD revision before flex load */
+    u_int32 deferred;   /* INIT_DEFERRED read from descriptor */
+    u_int64 t0;         /* start of init phase [us] */
+    u_int32 acc0;       /* busAcc at start of init phase */
+    int32   i;
 
-    count = 0;
-    n     = DATABUFSIZE;
-    
     /*------------------------------+
     |  prepare the handle           |
     +------------------------------*/
@@ -345,7 +750,28 @@ static int32 M47_Init(
     llHdl->memAlloc   = gotsize;
     llHdl->osHdl      = osHdl;
     llHdl->irqHdl     = irqHdl;
+    llHdl->devSemHdl  = devSemHdl;
     llHdl->ma         = *ma;
+    llHdl->usPerTick  = 1000000 / OSS_TickRateGet(osHdl);
+    llHdl->tickLast   = OSS_TickGet(osHdl);
+    llHdl->readMask   = CH_MASK_ALL;
+    llHdl->vecSeen    = STATUS_TRANSFER;    /* nothing sampled yet */
+
+    /* spin lock for ring buffer and position access */
+    if ((error = OSS_SpinLockCreate(osHdl, &llHdl->lockHdl)))
+        return( Cleanup(llHdl,error) );
+
+    /* init statistics */
+    acc0 = 0;
+    OSS_SpinLockAcquire( osHdl, llHdl->lockHdl );
+    t0 = M47_TimeUs( llHdl );
+    OSS_SpinLockRelease( osHdl, llHdl->lockHdl );
+
+    /* semaphores for waiting readers, one per channel */
+    for (i = 0; i < CH_NUMBER; i++)
+        if ((error = OSS_SemCreate(osHdl, OSS_SEM_BIN, 0,
+                                   &llHdl->readSemHdl[i])))
+            return( Cleanup(llHdl,error) );
 
     /*------------------------------+
     |  init id function table       |
@@ -406,63 +832,167 @@ static int32 M47_Init(
         error != ERR_DESC_KEY_NOTFOUND)
         return( Cleanup(llHdl,error) );
 
-    DBGWRT_2((DBH, "LL - modeReg = %08\n", modeReg));
-    
-    /* set M47 option structure */
-    llHdl->options[0].transMode =
-    llHdl->options[1].transMode =
-    llHdl->options[2].transMode =
-    llHdl->options[3].transMode = (u_int16)(modeReg >> 7);
-    
-    llHdl->options[0].dataWidth =
-    llHdl->options[1].dataWidth =
-    llHdl->options[2].dataWidth =
-    llHdl->options[3].dataWidth = (u_int16)(contReg >> 2);
-
-    llHdl->options[0].baudRate =
-    llHdl->options[1].baudRate =
-    llHdl->options[2].baudRate =
-    llHdl->options[3].baudRate = (u_int16)( (contReg & 0x00000003) );
-
-    /* check if option structure contains valid data */
-    if ( llHdl->options[0].transMode > 1 )
+    /* CONNECT_PERIOD */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0, 
+                                &connPeriod, "CONNECT_PERIOD")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    /* FLEX_LOAD */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, FLEX_LOAD_FORCE, 
+                                &flexLoad, "FLEX_LOAD")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if ( flexLoad > FLEX_LOAD_SKIP )
     {        
         error = ERR_LL_DESC_PARAM;
         DBGWRT_ERR((DBH," *** M47_Init: illegal descriptor parameter" 
-        "transmission mode= %d\n", 
-        llHdl->options[0].transMode ));
+        "flex load = %d\n", 
+        flexLoad ));
         return ( Cleanup(llHdl,error) );
     }
 
-    if ( llHdl->options[0].dataWidth > 32 )
+    /* INIT_DEFERRED */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, FALSE, 
+                                &deferred, "INIT_DEFERRED")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    /* SAMPLE_PERIOD */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0, 
+                                &period, "SAMPLE_PERIOD")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    /* SAMPLE_DEPTH */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, SAMPLE_DEPTH_DEFAULT, 
+                                &llHdl->sampleDepth, "SAMPLE_DEPTH")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    /* READ_TIMEOUT */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0, 
+                                &llHdl->readTimeout, "READ_TIMEOUT")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    /* MOTION_WINDOW */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, MOTION_WINDOW_DEFAULT, 
+                                &llHdl->motionWin, "MOTION_WINDOW")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if ( llHdl->motionWin < 1 || llHdl->motionWin >= MOTION_HIST )
     {        
         error = ERR_LL_DESC_PARAM;
         DBGWRT_ERR((DBH," *** M47_Init: illegal descriptor parameter" 
-        "data-width = %d\n", 
-        llHdl->options[0].dataWidth ));
+        "motion window = %d\n", 
+        llHdl->motionWin ));
         return ( Cleanup(llHdl,error) );
     }
-    
-    if ( llHdl->options[0].baudRate > 3 )
+
+    /* IRQ_SIM_PERIOD */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0, 
+                                &llHdl->irqSimPeriod, "IRQ_SIM_PERIOD")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if ( llHdl->sampleDepth > SAMPLE_DEPTH_MAX ||
+         (period && !llHdl->sampleDepth) )
     {        
         error = ERR_LL_DESC_PARAM;
         DBGWRT_ERR((DBH," *** M47_Init: illegal descriptor parameter" 
-        "baudrate = %d\n", 
-        llHdl->options[0].baudRate ));
+        "sample depth = %d\n", 
+        llHdl->sampleDepth ));
         return ( Cleanup(llHdl,error) );
     }
 
-    DBGWRT_2((DBH, "LL - modeTrans = %d\n", llHdl->options[0].transMode));
-    DBGWRT_2((DBH, "LL - dataWidth = %d\n", llHdl->options[0].dataWidth));
-    DBGWRT_2((DBH, "LL - baudRate = %d\n", llHdl->options[0].baudRate));
+    DBGWRT_2((DBH, "LL - modeReg = %08\n", modeReg));
+    
+    /* set M47 option structure, CHANNEL_n keys override the global ones */
+    for (i = 0; i < CH_NUMBER; i++)
+    {
+        /* CHANNEL_n/M47_CONTROL */
+        if ((error = DESC_GetUInt32(llHdl->descHdl, contReg, 
+                                    &value, "CHANNEL_%d/M47_CONTROL", i)) &&
+            error != ERR_DESC_KEY_NOTFOUND)
+            return( Cleanup(llHdl,error) );
+
+        llHdl->options[i].dataWidth = (u_int16)(value >> 2);
+        llHdl->options[i].baudRate  = (u_int16)(value & 0x00000003);
+
+        /* CHANNEL_n/M47_TRANSMODE */
+        if ((error = DESC_GetUInt32(llHdl->descHdl, modeReg, 
+                                    &value, "CHANNEL_%d/M47_TRANSMODE", i)) &&
+            error != ERR_DESC_KEY_NOTFOUND)
+            return( Cleanup(llHdl,error) );
+
+        llHdl->options[i].transMode = (u_int16)(value >> 7);
+
+        /* CHANNEL_n/GLITCH_LIMIT */
+        if ((error = DESC_GetUInt32(llHdl->descHdl, 0, 
+                                    &llHdl->glitchLimit[i],
+                                    "CHANNEL_%d/GLITCH_LIMIT", i)) &&
+            error != ERR_DESC_KEY_NOTFOUND)
+            return( Cleanup(llHdl,error) );
+
+        /* check if option structure contains valid data */
+        if ( llHdl->options[i].transMode > 1 )
+        {        
+            error = ERR_LL_DESC_PARAM;
+            DBGWRT_ERR((DBH," *** M47_Init: illegal descriptor parameter" 
+            "transmission mode= %d, ch=%d\n", 
+            llHdl->options[i].transMode, i ));
+            return ( Cleanup(llHdl,error) );
+        }
+
+        if ( llHdl->options[i].dataWidth > 32 )
+        {        
+            error = ERR_LL_DESC_PARAM;
+            DBGWRT_ERR((DBH," *** M47_Init: illegal descriptor parameter" 
+            "data-width = %d, ch=%d\n", 
+            llHdl->options[i].dataWidth, i ));
+            return ( Cleanup(llHdl,error) );
+        }
+
+        DBGWRT_2((DBH, "LL - ch%d: modeTrans=%d dataWidth=%d baudRate=%d\n",
+                  i, llHdl->options[i].transMode,
+                  llHdl->options[i].dataWidth, llHdl->options[i].baudRate));
+    }
+
+    M47_SelectReaders( llHdl );
+
+    /*------------------------------+
+    |  alloc ring buffers           |
+    +------------------------------*/
+    if (llHdl->sampleDepth) {
+        if ((llHdl->ringMem = (M47_RING_ENT*)OSS_MemGet(osHdl,
+                CH_NUMBER * llHdl->sampleDepth * sizeof(M47_RING_ENT),
+                &llHdl->ringAlloc)) == NULL)
+            return( Cleanup(llHdl,ERR_OSS_MEM_ALLOC) );
+
+        for (i=0; i<CH_NUMBER; i++)
+            llHdl->ring[i].buf = llHdl->ringMem + i * llHdl->sampleDepth;
+    }
+
+    M47_InitPhase( llHdl, M47_INIT_DESC, &t0, &acc0 );
+
+    /*------------------------------+
+    |  read ID PROM                 |
+    +------------------------------*/
+    /* slow serial access: read once, served from the copy later */
+    for (i = 0; i < MOD_ID_SIZE/2; i++)
+        llHdl->idProm[i] = (u_int16) m_read((U_INT32_OR_64)llHdl->ma, i);
+    llHdl->busAcc += MOD_ID_SIZE/2;     /* counted in words */
+    DBGWRT_2((DBH, "LL - EEPROM read\n"));
 
     /*------------------------------+
     |  check module ID              |
     +------------------------------*/
     if (llHdl->idCheck) {
-        int modIdMagic = m_read((U_INT32_OR_64)llHdl->ma, 0);
-        int modId      = m_read((U_INT32_OR_64)llHdl->ma, 1);
-        DBGWRT_2((DBH, "LL - EEPROM read\n"));
+        int modIdMagic = llHdl->idProm[0];
+        int modId      = llHdl->idProm[1];
         if (modIdMagic != MOD_ID_MAGIC) {
             DBGWRT_ERR((DBH," *** M47_Init: illegal magic=0x%04x\n",modIdMagic));
             error = ERR_LL_ILL_ID;
@@ -478,83 +1008,85 @@ static int32 M47_Init(
     /*------------------------------+
     |  Read module revision number  |
     +------------------------------*/
-    llHdl->moduleHwRev = (u_int16) m_read((U_INT32_OR_64)llHdl->ma, 2);
+    llHdl->moduleHwRev = llHdl->idProm[2];
     DBGWRT_1((DBH, "LL - M47 HW Revision = 0x%04X\n", llHdl->moduleHwRev ));
 
+    /* below HW revision 2 baud rate and data width are common */
+    if ( llHdl->moduleHwRev < HW_MAJOR_REV_2 )
+    {
+        for (i = 1; i < CH_NUMBER; i++)
+        {
+            if ( llHdl->options[i].dataWidth != llHdl->options[0].dataWidth ||
+                 llHdl->options[i].baudRate  != llHdl->options[0].baudRate )
+            {
+                error = ERR_LL_DESC_PARAM;
+                DBGWRT_ERR((DBH," *** M47_Init: CHANNEL_%d/M47_CONTROL "
+                "requires HW revision 2.0\n", i ));
+                return ( Cleanup(llHdl,error) );
+            }
+        }
+    }
+
+    M47_InitPhase( llHdl, M47_INIT_ID, &t0, &acc0 );
+
     /*------------------------------+
     |  init hardware                |
     +------------------------------*/
     
 
     DBGWRT_3((DBH, "LL - Mode/PLD Revision Register = %04X\n", 
-    MREAD_D16( llHdl->ma, MODE_REV_CH0)));
+    M47_RD16( llHdl, MODE_REV_CH0)));
 
-    /* Flex load */
-    m47_flexload(llHdl);
-    DBGWRT_2((DBH, "LL - Flex loaded\n"));
-    
-    
-    DBGWRT_2((DBH, "LL - Mode/PLD Revision Register = %04X\n", 
-    MREAD_D16( llHdl->ma, MODE_REV_CH0)));
-    
+    llHdl->validTimeout = VALID_TIMEOUT_DEFAULT;
 
-    DBGWRT_2((DBH, "LL - Read Control Register\n"
-                   " CONTREG_CH0 = %04X\n"
-                   " CONTREG_CH1 = %04X\n"
-                   " CONTREG_CH2 = %04X\n"
-                   " CONTREG_CH3 = %04X\n", 
-                   MREAD_D16( llHdl->ma, CONTREG_CH0),
-                   MREAD_D16( llHdl->ma, CONTREG_CH1),
-                   MREAD_D16( llHdl->ma, CONTREG_CH2),
-                   MREAD_D16( llHdl->ma, CONTREG_CH3)));
-
-    /* Stop transmission */
-    MWRITE_D16( llHdl->ma, CONTREG_CH0, 0x0000 );
-    DBGWRT_2((DBH, "LL - Transmission stopped\n"
-                   " CONTREG_CH0 = %04X\n"
-                   " CONTREG_CH1 = %04X\n"
-                   " CONTREG_CH2 = %04X\n"
-                   " CONTREG_CH3 = %04X\n", 
-                   MREAD_D16( llHdl->ma, CONTREG_CH0),
-                   MREAD_D16( llHdl->ma, CONTREG_CH1),
-                   MREAD_D16( llHdl->ma, CONTREG_CH2),
-                   MREAD_D16( llHdl->ma, CONTREG_CH3)));
-    
-    /* Clear data RAM */    
-    while (n--)
-    {
-        MWRITE_D16( llHdl->ma, (REG_START + count), 0x0000);
-        count +=2;
+    /* Flex load, unless the expected PLD is already running */
+    pldRev = M47_RD16( llHdl, MODE_REV_CH0 ) & 0x000f;
+
+    if ( flexLoad == FLEX_LOAD_FORCE ||
+         (flexLoad == FLEX_LOAD_AUTO && pldRev != M47_FlexPldRev()) ) {
+        if (deferred) {
+            /* load in the background, M47_InitFinish calls M47_InitHw */
+            M47_FlexLoadZStart( &llHdl->flexState );
+            llHdl->initDeferred = TRUE;
+            llHdl->initT0   = t0;
+            llHdl->initAcc0 = acc0;
+
+            if ((error = OSS_AlarmCreate(osHdl, M47_InitAlarm, llHdl,
+                                         &llHdl->initAlarmHdl)) ||
+                (error = OSS_AlarmSet(osHdl, llHdl->initAlarmHdl,
+                                      INIT_ALARM_MS, 1, &value)))
+                return( Cleanup(llHdl,error) );
+
+            DBGWRT_2((DBH, "LL - Flex load deferred\n"));
+        }
+        else {
+            m47_flexload(llHdl);
+            llHdl->flexHash = M47_FLEXZ_HASH;
+            DBGWRT_2((DBH, "LL - Flex loaded\n"));
+        }
+    }
+    else {
+        /* AUTO: the built-in bitstream is running */
+        if (flexLoad == FLEX_LOAD_AUTO)
+            llHdl->flexHash = M47_FLEXZ_HASH;
+        DBGWRT_2((DBH, "LL - Flex load skipped, PLD rev %d\n", pldRev));
     }
 
-    DBGWRT_2((DBH, "LL - RAM Cleared\n"));
-    
-    /* Write mode to Mode/PLD Revision Register */
-    MWRITE_D16( llHdl->ma, MODE_REV_CH0, ((u_int16) modeReg));
-
-    DBGWRT_2((DBH, "LL - Mode/PLD Revision Register (desc. value set)\n"
-                   " MODE_REV_CH0 = %04X\n"
-                   " MODE_REV_CH1 = %04X\n"
-                   " MODE_REV_CH2 = %04X\n"
-                   " MODE_REV_CH3 = %04X\n", 
-                   MREAD_D16( llHdl->ma, MODE_REV_CH0),
-                   MREAD_D16( llHdl->ma, MODE_REV_CH1),
-                   MREAD_D16( llHdl->ma, MODE_REV_CH2),
-                   MREAD_D16( llHdl->ma, MODE_REV_CH3)));
-
-    /* Load Control Register */
-    MWRITE_D16( llHdl->ma, CONTREG_CH0, ((u_int16) contReg) );
-
-    DBGWRT_2((DBH, "LL - Descriptor value M47_CONTROL = %08X\n", contReg));
-    DBGWRT_2((DBH, "LL - Read Controll Register (desc. value set)\n"
-                   " CONTREG_CH0 = %04X\n"
-                   " CONTREG_CH1 = %04X\n"
-                   " CONTREG_CH2 = %04X\n"
-                   " CONTREG_CH3 = %04X\n", 
-                   MREAD_D16( llHdl->ma, CONTREG_CH0),
-                   MREAD_D16( llHdl->ma, CONTREG_CH1),
-                   MREAD_D16( llHdl->ma, CONTREG_CH2),
-                   MREAD_D16( llHdl->ma, CONTREG_CH3)));
+    if (!llHdl->initAlarmHdl) {
+        M47_InitPhase( llHdl, M47_INIT_FLEX, &t0, &acc0 );
+        M47_InitHw( llHdl );
+        M47_InitPhase( llHdl, M47_INIT_HW, &t0, &acc0 );
+    }
+
+    /* start background sampling */
+    if ((error = M47_SampleStart(llHdl, period)))
+        return( Cleanup(llHdl,error) );
+
+    /* start connection monitor */
+    if ((error = M47_ConnectStart(llHdl, connPeriod)))
+        return( Cleanup(llHdl,error) );
+
+    M47_InitPhase( llHdl, M47_INIT_START, &t0, &acc0 );
     
     *llHdlP = llHdl;    /* set low-level driver handle */
 
@@ -567,7 +1099,8 @@ static int32 M47_Init(
  *
  *                The function stops the transmission by setting the data
  *                width to 0 (i.e. it writes 0x0000 to the Control Register).
- *                The interrupt is disabled.
+ *                The interrupt is disabled, background sampling and
+ *                connection monitoring are stopped.
  *
  *---------------------------------------------------------------------------
  *  Input......:  llHdlP    pointer to low-level driver handle
@@ -587,6 +1120,19 @@ static int32 M47_Exit(
     |  de-init hardware             |
     +------------------------------*/
 
+    /* stop deferred init */
+    if (llHdl->initAlarmHdl)
+        OSS_AlarmClear(llHdl->osHdl, llHdl->initAlarmHdl);
+
+    /* stop background sampling */
+    M47_SampleStart(llHdl, 0);
+
+    /* stop connection monitor */
+    M47_ConnectStart(llHdl, 0);
+
+    /* disable interrupt */
+    M47_IrqEnable(llHdl, FALSE);
+
     /* Stop Transmission */
     MWRITE_D16( llHdl->ma, CONTREG_CH0, 0x0000 );
     
@@ -613,6 +1159,9 @@ static int32 M47_Exit(
  *                    +-------------------------------------+
  *                    |  reserved  |     valid data         |
  *                    +-------------------------------------+
+ *
+ *                The value is the raw data word; the glitch filter
+ *                (M47_GLITCH_LIMIT) doesn't apply to it.
  *---------------------------------------------------------------------------
  *  Input......:  llHdl    low-level handle
  *                ch       current channel
@@ -626,43 +1175,27 @@ static int32 M47_Read(
     int32 *valueP
 )
 {
-    register u_int32   data;
-    register u_int8    dummy;
-
-
-    data = 0;
+    u_int32 data;
 
+#ifndef M47_FAST
     DBGWRT_1((DBH, "LL - M47_Read: ch=%d\n",ch));
 
     DBGDMP_2((DBH,"REGS",(void *)llHdl->ma,0x20,2));    
+#endif
 
-    /* Read d32..d24 */
-    dummy = ((u_int8) MREAD_D16 (llHdl->ma, DATACH(ch)));
-    data |= dummy;
-    data <<= 8;
-
-    DBGWRT_2((DBH, "LL - M47_Read: data=%08X\n", data));
-    
-    /* Read d23..d16 */
-    dummy = ((u_int8) MREAD_D16 (llHdl->ma, (DATACH(ch) + 0x02)));
-    data |= dummy;
-    data <<= 8;
-
-    DBGWRT_2((DBH, "LL - M47_Read: data=%08X\n", data));
-
-    /* Read d15..d8 */
-    dummy = ((u_int8) MREAD_D16 (llHdl->ma, (DATACH(ch) + 0x04)));
-    data |= dummy;
-    data <<= 8;
-    
-    DBGWRT_2((DBH, "LL - M47_Read: data=%08X\n", data));
+    if (!llHdl->ready && !M47_InitFinish(llHdl))
+        return(ERR_LL_DEV_NOTRDY);
 
-    /* Read d8..d0 */
-    
-    dummy = ((u_int8) MREAD_D16 (llHdl->ma, (DATACH(ch) + 0x06)));
-    data |= dummy;
+#ifndef M47_FAST
+    data = M47_ReadData( llHdl, ch );
     
     DBGWRT_2((DBH, "LL - M47_Read: data=%08X\n", data));
+#else
+    if (llHdl->consistRead || llHdl->swGray[ch])
+        data = M47_ReadData( llHdl, ch );
+    else
+        M47_FAST_DATA( llHdl->ma, ch, llHdl->dataBytes[ch], data );
+#endif
 
     *valueP = data;
 
@@ -703,10 +1236,82 @@ static int32 M47_Write(
  *                M_MK_IRQ_ENABLE      interrupt enable            0..1
  *                M_LL_IRQ_COUNT       interrupt counter           0..max
  *                M_LL_CH_DIR          direction of curr. chan.    M_CH_???
+ *                M47_READ_TIMEOUT     FIFO read timeout           0..max [ms]
+ *                M47_VALID_TIMEOUT    M47_WAIT_VALID timeout      0..max [ms]
  *                M47_BAUDRATE         baud rate for SSI device    0..3
  *                M47_DATA_WIDTH       data width                  0..32
  *                M47_TRANS_MODE       transmission mode           0 (Gray) 
  *                                                                   1 (binary)
+ *                M47_BLKRD_MODE       M_getblock mode             see below
+ *                M47_READ_MASK        M47_BLKRD_VECTOR channels   0x01..0x0f
+ *                M47_SAMPLE_PERIOD    background sampling period  0..max [ms]
+ *                M47_CONNECT_PERIOD   connection monitor period   0..max [ms]
+ *                M47_FIFO_OVERRUN     overrun counter of curr. CH 0..max
+ *                M47_FIFO_FLUSH       discard buffered samples    -
+ *                M47_CONSISTENT_READ  re-read torn data words     0..1
+ *                M47_TEAR_COUNT       torn reads of curr. CH      0..max
+ *                M47_GLITCH_LIMIT     glitch filter velocity      0..max
+ *                                     limit of curr. CH           [counts/s]
+ *                M47_GLITCH_COUNT     rejected data words of      0..max
+ *                                     curr. CH
+ *                M47_POS64_RESET      restart unwrapping of curr. -
+ *                                     CH at the current data word
+ *                M47_BLK_POS64        preset position of curr. CH int64
+ *                M47_MOTION_WINDOW    motion filter window        1..15
+ *                M47_BLK_CONFIG       configuration of all CHs    M47_CONFIG
+ *                M47_BLK_FLEXLOAD     load PLD bitstream          M47_FLEXBLOB
+ *
+ *                M47_BLK_CONFIG validates and applies baud rate, data
+ *                width and transmission mode of all channels with a
+ *                single M47_Reconfig pass. Below HW revision
+ *                2.0, baud rate and data width must be equal for all
+ *                channels.
+ *
+ *                M47_BLK_FLEXLOAD loads a bitstream file into the PLD
+ *                instead of the built-in one. The file follows the
+ *                M47_FLEXBLOB header. It is skipped if its hash equals
+ *                the one of the loaded bitstream (M47_FLEX_HASH).
+ *
+ *                M47_BLKRD_MODE selects the M47_BlockRead data format:
+ *                    0 = M47_BLKRD_SNAPSHOT one value of each channel
+ *                    1 = M47_BLKRD_FIFO     buffered M47_SAMPLE records of
+ *                                           the current channel
+ *                    2 = M47_BLKRD_FIFO_TS  buffered M47_TSAMPLE records
+ *                                           (with timestamps) of the
+ *                                           current channel
+ *                    3 = M47_BLKRD_POS64    continuous position of each
+ *                                           channel (int64)
+ *                    4 = M47_BLKRD_COHERENT M47_SNAPSHOT of all channels
+ *                    5 = M47_BLKRD_FLAGGED  M47_FSAMPLE of each channel
+ *                    6 = M47_BLKRD_VECTOR   consecutive samples of the
+ *                                           M47_READ_MASK channels, each
+ *                                           with a sequence number
+ *
+ *                M47_READ_MASK selects the channels read in
+ *                    M47_BLKRD_VECTOR mode (bit n = channel n, default
+ *                    0x0f).
+ *
+ *                M47_SAMPLE_PERIOD starts (>0) or stops (0) background
+ *                    sampling. Requires SAMPLE_DEPTH > 0.
+ *
+ *                M47_GLITCH_LIMIT sets the glitch filter of the current
+ *                    channel (0 = off). A data word further from the last
+ *                    good one than the channel can move at this velocity
+ *                    doesn't update the continuous position (M47_BLK_POS64,
+ *                    M47_BLKRD_POS64) and the motion values; it is counted
+ *                    in M47_GLITCH_COUNT. Data words returned by M47_Read
+ *                    and the other M47_BLKRD_xxx modes are not filtered.
+ *
+ *                M_MK_IRQ_ENABLE enables the simulated frame-complete
+ *                    interrupt (IRQ_SIM_PERIOD). Each interrupt captures
+ *                    all enabled channels into the ring buffers. Requires
+ *                    SAMPLE_DEPTH > 0. Without IRQ_SIM_PERIOD there is no
+ *                    interrupt source and enabling fails with
+ *                    ERR_LL_ILL_FUNC.
+ *
+ *                While an INIT_DEFERRED load is running (M47_READY = 0),
+ *                all codes except M_LL_DEBUG_LEVEL fail with
+ *                ERR_LL_DEV_NOTRDY.
  *
  *                M47_BAUDRATE sets the baud rate for the SSI device:
  *                    0 = 500 kbaud
@@ -724,6 +1329,17 @@ static int32 M47_Write(
  *                M47_TRANS_MODE_CH    trans. mode for specific CH 0 (Gray) 
  *                                                                 1 (binary)
  *
+ *                M47_TRANS_MODE_CH is also valid below HW revision 2.0.
+ *                If the channels use different modes there, the Gray
+ *                channels are decoded in software.
+ *
+ *                On HW revision 2.0 or higher, all configuration codes
+ *                (including the global M47_BAUDRATE, M47_DATA_WIDTH and
+ *                M47_TRANS_MODE) only affect channels whose settings
+ *                change; the others keep delivering data. A changed baud
+ *                rate or data width restarts the channel, a changed
+ *                transmission mode takes effect with its next frame.
+ *
  *---------------------------------------------------------------------------
  *  Input......:  llHdl         low-level handle
  *                code          status code
@@ -742,17 +1358,18 @@ static int32 M47_SetStat(
 )
 {
     int32 error = ERR_SUCCESS;
-    u_int16 n;
-    u_int16 count;
     
     int32 value = (int32)value32_or_64; /* 32bit value */
-    
-    count = 0;
-    n     = DATABUFSIZE;
+    M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64; /* stores block struct pointer */
 
     DBGWRT_1((DBH, "LL - M47_SetStat: ch=%d code=0x%04x value=0x%x\n",
               ch,code,value));
 
+    /* deferred init running: nothing to set up yet */
+    if (!llHdl->ready && !M47_InitFinish(llHdl) &&
+        code != M_LL_DEBUG_LEVEL)
+        return(ERR_LL_DEV_NOTRDY);
+
     switch(code) {
         /*--------------------------+
         |  debug level              |
@@ -764,7 +1381,7 @@ static int32 M47_SetStat(
         |  enable interrupts        |
         +--------------------------*/
         case M_MK_IRQ_ENABLE:
-            error = ERR_LL_UNK_CODE;    /* say: not supported */
+            error = M47_IrqEnable( llHdl, value ? TRUE : FALSE );
             break;
         /*--------------------------+
         |  set irq counter          |
@@ -810,18 +1427,7 @@ static int32 M47_SetStat(
             llHdl->options[2].baudRate =
             llHdl->options[3].baudRate = (u_int16) value;
             
-            /* stop transmission */
-            MWRITE_D16( llHdl->ma, CONTREG_CH0, 0x0000 );
-
-               /* clear data RAM */    
-            while (n--)
-            {
-                MWRITE_D16( llHdl->ma, (REG_START + count), 0x0000);
-                count +=2;
-            }
-            
-            MWRITE_D16(llHdl->ma, CONTREG_CH0, ((llHdl->options[0].baudRate) | 
-            (llHdl->options[0].dataWidth << 2)));
+            M47_Reconfig( llHdl );
             
             break;
 
@@ -841,18 +1447,7 @@ static int32 M47_SetStat(
             llHdl->options[2].dataWidth =
             llHdl->options[3].dataWidth = (u_int16) value;
 
-            /* stop transmission */
-            MWRITE_D16( llHdl->ma, CONTREG_CH0, 0x0000 );
-
-            /* clear data RAM */    
-            while (n--)
-            {
-                MWRITE_D16( llHdl->ma, (REG_START + count), 0x0000);
-                count +=2;
-            }
-            
-            MWRITE_D16(llHdl->ma, CONTREG_CH0, ((llHdl->options[0].baudRate) | 
-            (llHdl->options[0].dataWidth << 2)));
+            M47_Reconfig( llHdl );
             
             break;
 
@@ -860,6 +1455,8 @@ static int32 M47_SetStat(
         |  set M47 transmission mode for all channels  |
         +---------------------------------------------*/
         case M47_TRANS_MODE:
+        {
+            int32 i;
 
             if(value < 0 || value > 1)
             {
@@ -867,29 +1464,16 @@ static int32 M47_SetStat(
                 break;
             }
             
-            llHdl->options[0].transMode =
-            llHdl->options[1].transMode =
-            llHdl->options[2].transMode =
-            llHdl->options[3].transMode = (u_int16) value;
-            
-            /* stop transmission */
-            MWRITE_D16( llHdl->ma, CONTREG_CH0, 0x0000 );
-
-            /* clear data RAM */    
-            while (n--)
-            {
-                MWRITE_D16( llHdl->ma, (REG_START + count), 0x0000);
-                count +=2;
+            for( i = 0; i < CH_NUMBER; i++ ) {
+                if (llHdl->options[i].transMode != (u_int16)value)
+                    M47_UnwrapReset( llHdl, i );
+                llHdl->options[i].transMode = (u_int16) value;
             }
 
-            /* set transmission mode */
-            MWRITE_D16(llHdl->ma, MODE_REV_CH0, (llHdl->options[0].transMode << 7));
-
-            /* reinitialize transmission */
-            MWRITE_D16(llHdl->ma, CONTREG_CH0, ((llHdl->options[0].baudRate) | 
-            (llHdl->options[0].dataWidth << 2)));
+            M47_Reconfig( llHdl );
             
             break;
+        }
 
         /*-----------------------------------------+
         |  set M47 baud rate for specific channel  |
@@ -917,8 +1501,7 @@ static int32 M47_SetStat(
                 
             llHdl->options[ch].baudRate = (u_int16) value;
             
-            /* update Control Register */
-            M47_UpdateControlRegs( llHdl );
+            M47_Reconfig( llHdl );
             
             break;
 
@@ -948,8 +1531,7 @@ static int32 M47_SetStat(
             
             llHdl->options[ch].dataWidth = (u_int16) value;
             
-            /* update control register */
-            M47_UpdateControlRegs( llHdl );
+            M47_Reconfig( llHdl );
             
             break;
 
@@ -958,12 +1540,6 @@ static int32 M47_SetStat(
         +-------------------------------------------------*/
         case M47_TRANS_MODE_CH:
 
-            /* check module HW Revision */
-            if( llHdl->moduleHwRev < HW_MAJOR_REV_2 ) {
-                error = ERR_LL_ILL_FUNC;
-                break;
-            }
-
             /* check if channel in range */
             if(ch < 0 || ch > 3)
             {
@@ -977,39 +1553,285 @@ static int32 M47_SetStat(
                 break;
             }
             
-            llHdl->options[ch].transMode = (u_int16) value;
+            if (llHdl->options[ch].transMode != (u_int16)value)
+                M47_UnwrapReset( llHdl, ch );
 
-            /* set transmission mode */
-            MWRITE_D16(llHdl->ma, MODE_REV_CH0, (llHdl->options[0].transMode << 7));
-            MWRITE_D16(llHdl->ma, MODE_REV_CH1, (llHdl->options[1].transMode << 7));
-            MWRITE_D16(llHdl->ma, MODE_REV_CH2, (llHdl->options[2].transMode << 7));
-            MWRITE_D16(llHdl->ma, MODE_REV_CH3, (llHdl->options[3].transMode << 7));
+            llHdl->options[ch].transMode = (u_int16) value;
 
-            DBGWRT_3((DBH, "LL - M47_SetStat: MODE_REV_CH0 = 0x%04x\n",
-                     MREAD_D16(llHdl->ma, MODE_REV_CH0)));
+            /* HW revision < 2: global mode, Gray decoded in software */
+            M47_Reconfig( llHdl );
+            
+            break;
 
-            DBGWRT_3((DBH, "LL - M47_SetStat: MODE_REV_CH1 = 0x%04x\n",
-                     MREAD_D16(llHdl->ma, MODE_REV_CH1)));
+        /*--------------------------+
+        |  FIFO read timeout        |
+        +--------------------------*/
+        case M47_READ_TIMEOUT:
 
-            DBGWRT_3((DBH, "LL - M47_SetStat: MODE_REV_CH2 = 0x%04x\n",
-                     MREAD_D16(llHdl->ma, MODE_REV_CH2)));
+            if(value < 0)
+            {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
 
-            DBGWRT_3((DBH, "LL - M47_SetStat: MODE_REV_CH3 = 0x%04x\n",
-                     MREAD_D16(llHdl->ma, MODE_REV_CH3)));
-                           
-            /* update Control Register */
-            M47_UpdateControlRegs( llHdl );
-            
+            llHdl->readTimeout = value;
             break;
 
         /*--------------------------+
-        |  (unknown)                |
+        |  data valid timeout       |
         +--------------------------*/
-        default:
-            error = ERR_LL_UNK_CODE;
-    }
+        case M47_VALID_TIMEOUT:
 
-    return(error);
+            if(value < 0)
+            {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+
+            llHdl->validTimeout = value;
+            break;
+
+        /*--------------------------+
+        |  M_getblock mode          |
+        +--------------------------*/
+        case M47_BLKRD_MODE:
+
+            if(value < M47_BLKRD_SNAPSHOT || value > M47_BLKRD_VECTOR)
+            {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+
+            /* FIFO modes need ring buffers */
+            if( (value == M47_BLKRD_FIFO || value == M47_BLKRD_FIFO_TS) &&
+                !llHdl->sampleDepth ) {
+                error = ERR_LL_ILL_FUNC;
+                break;
+            }
+
+            llHdl->blkRdMode = value;
+            break;
+
+        /*--------------------------+
+        |  vectored read channels   |
+        +--------------------------*/
+        case M47_READ_MASK:
+
+            if(value <= 0 || value > CH_MASK_ALL)
+            {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+
+            llHdl->readMask = value;
+            break;
+
+        /*--------------------------+
+        |  background sampling      |
+        +--------------------------*/
+        case M47_SAMPLE_PERIOD:
+
+            if(value < 0)
+            {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+
+            error = M47_SampleStart( llHdl, (u_int32)value );
+            break;
+
+        /*--------------------------+
+        |  connection monitoring    |
+        +--------------------------*/
+        case M47_CONNECT_PERIOD:
+
+            if(value < 0)
+            {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+
+            error = M47_ConnectStart( llHdl, (u_int32)value );
+            break;
+
+        /*--------------------------+
+        |  ring buffer overruns     |
+        +--------------------------*/
+        case M47_FIFO_OVERRUN:
+
+            /* check if channel in range */
+            if(ch < 0 || ch > 3)
+            {
+                error = ERR_LL_ILL_CHAN;
+                break;
+            }
+
+            OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+            llHdl->ring[ch].overrun = value;
+            OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+            break;
+
+        /*--------------------------+
+        |  discard buffered samples |
+        +--------------------------*/
+        case M47_FIFO_FLUSH:
+        {
+            int32 i;
+
+            OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+            for( i = 0; i < CH_NUMBER; i++ ) {
+                llHdl->ring[i].rdIdx = llHdl->ring[i].wrIdx;
+                llHdl->ring[i].count = 0;
+            }
+            OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+            break;
+        }
+
+        /*--------------------------+
+        |  consistent read mode     |
+        +--------------------------*/
+        case M47_CONSISTENT_READ:
+
+            if(value < 0 || value > 1)
+            {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+
+            llHdl->consistRead = value;
+            break;
+
+        /*--------------------------+
+        |  tear counter             |
+        +--------------------------*/
+        case M47_TEAR_COUNT:
+
+            /* check if channel in range */
+            if(ch < 0 || ch > 3)
+            {
+                error = ERR_LL_ILL_CHAN;
+                break;
+            }
+
+            llHdl->tearCount[ch] = value;
+            break;
+
+        /*--------------------------+
+        |  glitch filter            |
+        +--------------------------*/
+        case M47_GLITCH_LIMIT:
+        case M47_GLITCH_COUNT:
+
+            /* check if channel in range */
+            if(ch < 0 || ch > 3)
+            {
+                error = ERR_LL_ILL_CHAN;
+                break;
+            }
+
+            OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+            if (code == M47_GLITCH_LIMIT) {
+                llHdl->glitchLimit[ch] = value;
+                llHdl->glitchRun[ch]   = 0;
+            }
+            else
+                llHdl->glitchCount[ch] = value;
+            OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+            break;
+
+        /*--------------------------+
+        |  restart unwrapping       |
+        +--------------------------*/
+        case M47_POS64_RESET:
+
+            /* check if channel in range */
+            if(ch < 0 || ch > 3)
+            {
+                error = ERR_LL_ILL_CHAN;
+                break;
+            }
+
+            M47_UnwrapReset( llHdl, ch );
+            break;
+
+        /*--------------------------+
+        |  preset position          |
+        +--------------------------*/
+        case M47_BLK_POS64:
+
+            /* check if channel in range */
+            if(ch < 0 || ch > 3)
+            {
+                error = ERR_LL_ILL_CHAN;
+                break;
+            }
+
+            if (blk->size < (int32)sizeof(int64))
+            {
+                error = ERR_LL_USERBUF;
+                break;
+            }
+
+            /* current data word becomes the preset position */
+            M47_Unwrap( llHdl, ch, M47_ReadData( llHdl, ch ) );
+
+            OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+            {
+                int64   offs = *(int64*)blk->data - llHdl->pos[ch];
+                u_int32 i;
+
+                /* shift motion history, velocity is unaffected */
+                for (i = 0; i < MOTION_HIST; i++)
+                    llHdl->hist[ch][i].pos += offs;
+
+                llHdl->pos[ch] += offs;
+            }
+            OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+            break;
+
+        /*--------------------------+
+        |  module configuration     |
+        +--------------------------*/
+        case M47_BLK_CONFIG:
+
+            if (blk->size < (int32)sizeof(M47_CONFIG))
+            {
+                error = ERR_LL_USERBUF;
+                break;
+            }
+
+            error = M47_ApplyConfig( llHdl, (M47_CONFIG*)blk->data );
+            break;
+
+        /*--------------------------+
+        |  load PLD bitstream       |
+        +--------------------------*/
+        case M47_BLK_FLEXLOAD:
+            error = M47_FlexLoadBlob( llHdl, blk );
+            break;
+
+        /*--------------------------+
+        |  motion filter window     |
+        +--------------------------*/
+        case M47_MOTION_WINDOW:
+
+            if(value < 1 || value >= MOTION_HIST)
+            {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+
+            llHdl->motionWin = value;
+            break;
+
+        /*--------------------------+
+        |  (unknown)                |
+        +--------------------------*/
+        default:
+            error = ERR_LL_UNK_CODE;
+    }
+
+    return(error);
 }
 
 /****************************** M47_GetStat **********************************
@@ -1028,7 +1850,7 @@ static int32 M47_SetStat(
  *                M_LL_IRQ_COUNT       interrupt counter           0..max
  *                M_LL_ID_CHECK        ID is checked               0..1
  *                M_LL_ID_SIZE         EEPROM size [bytes]         128
- *                M_LL_BLK_ID_DATA     EEPROM raw data             -
+ *                M_LL_BLK_ID_DATA     EEPROM raw data (init copy) -
  *                M_MK_BLK_REV_ID      ident function table ptr    -
  *                M47_CHECK_CONNECT    check sensor connection     see below
  *                M47_BAUDRATE         baudrate for transmission   0..3 
@@ -1036,9 +1858,79 @@ static int32 M47_SetStat(
  *                M47_TRANS_MODE       transmission mode           0 (Gray) 
  *                                                                 1 (binary)
  *                M47_PLD_REV          PLD revision number         0..max
+ *                M47_BLKRD_MODE       M_getblock mode             0..6
+ *                M47_READ_MASK        M47_BLKRD_VECTOR channels   0x01..0x0f
+ *                M47_SAMPLE_PERIOD    real sampling period        0..max [ms]
+ *                M47_FIFO_COUNT       buffered samples of curr CH 0..max
+ *                M47_FIFO_OVERRUN     overrun counter of curr. CH 0..max
+ *                M47_READ_TIMEOUT     FIFO read timeout           0..max [ms]
+ *                M47_VALID_TIMEOUT    M47_WAIT_VALID timeout      0..max [ms]
+ *                M47_CFG_GEN          config generation of curr.  0..max
+ *                                     CH
+ *                M47_WAIT_VALID       wait for valid data of      config
+ *                                     curr. CH                    generation
+ *                M47_CONSISTENT_READ  re-read torn data words     0..1
+ *                M47_TEAR_COUNT       torn reads of curr. CH      0..max
+ *                M47_GLITCH_LIMIT     glitch filter velocity      0..max
+ *                                     limit of curr. CH           [counts/s]
+ *                M47_GLITCH_COUNT     rejected data words of      0..max
+ *                                     curr. CH
+ *                M47_BLK_POS64        continuous positions of     int64[4]
+ *                                     channels 0..3 (last update)
+ *                M47_VELOCITY         velocity of curr. CH        see below
+ *                M47_ACCEL            acceleration of curr. CH    see below
+ *                M47_MOTION_WINDOW    motion filter window        1..15
+ *                M47_BLK_MOTION       motion of channels 0..3     M47_MOTION[4]
+ *                M47_BLK_CONFIG       configuration of all CHs    M47_CONFIG
+ *                M47_FLEX_HASH        hash of loaded bitstream    0 = unknown
+ *                M47_READY            hardware initialized        0..1
+ *                M47_BLK_INITSTAT     init phase statistics       M47_INITSTAT
+ *
+ *                M47_BLK_INITSTAT reports duration (system tick resolution)
+ *                and register accesses of each M47_Init phase. With
+ *                INIT_DEFERRED, the FLEX phase lasts from M47_Init until
+ *                the background load completed. ID PROM accesses are
+ *                counted in words.
+ *
+ *                M47_READY is 0 while an INIT_DEFERRED load is running.
+ *                The first call after the load programs the registers,
+ *                then M47_READY is 1.
+ *                Until then, only the M_LL_xxx info codes, M47_HW_REV,
+ *                M47_READY and M47_BLK_INITSTAT are available, others
+ *                fail with ERR_LL_DEV_NOTRDY.
+ *
+ *                M47_VELOCITY and M47_ACCEL are fixed point values in
+ *                1/2^M47_MOTION_FRAC counts/s (counts/s^2), saturated to
+ *                32 bit. They are estimated from the last
+ *                M47_MOTION_WINDOW+1 position updates at least a frame
+ *                time apart (see M47_Motion).
+ *
+ *                M47_VELOCITY, M47_ACCEL and M47_BLK_MOTION read the
+ *                channel(s) and update the continuous position first.
+ *                Besides them, only M47_BLKRD_POS64 reads, background
+ *                sampling and the simulated interrupt track the position
+ *                (see M47_Unwrap); plain data word reads don't.
+ *
  *
+ *                M47_CONNECT_AGE      age of M47_CHECK_CONNECT    0..max [ms]
+ *                                     result (-1 = never checked)
+ *                M47_CONNECT_PERIOD   real monitor period         0..max [ms]
  *
- *                M47_CHECK_CONNECT checks the sensor connection:
+ *                M47_WAIT_VALID blocks until the current channel delivered
+ *                a frame with its current configuration, at most for
+ *                M47_VALID_TIMEOUT (ERR_OSS_TIMEOUT). Each change of the
+ *                channel's control or mode register starts a new
+ *                configuration generation (M47_CFG_GEN). Other calls on
+ *                the device are not blocked while waiting. A reconfig
+ *                meanwhile extends the wait to the new generation; a
+ *                bitstream load meanwhile fails with ERR_LL_DEV_NOTRDY.
+ *
+ *                M47_CHECK_CONNECT checks the sensor connection.
+ *                With connection monitoring (M47_CONNECT_PERIOD), the
+ *                cached result of the monitor is returned immediately.
+ *                Otherwise the transfer bits are probed until all enabled
+ *                channels transferred or 4 ms elapsed (other calls on
+ *                the device are not blocked meanwhile):
  *                    Bit      7..4        3..0
  *                        +------------------------+ 
  *                        |     RES    |TD|TC|TB|TA|
@@ -1067,6 +1959,10 @@ static int32 M47_SetStat(
  *                M47_TRANS_MODE_CH    trans. mode for spceific CH 0 (Gray) 
  *                                                                 1 (binary)
  *
+ *                M47_TRANS_MODE_CH is also valid below HW revision 2.0.
+ *                If the channels use different modes there, the Gray
+ *                channels are decoded in software.
+ *
  *---------------------------------------------------------------------------
  *  Input......:  llHdl             low-level handle
  *                code              status code
@@ -1092,8 +1988,31 @@ static int32 M47_GetStat(
 
     int32 error = ERR_SUCCESS;
 
+#ifndef M47_FAST
     DBGWRT_1((DBH, "LL - M47_GetStat: ch=%d code=0x%04x\n",
               ch,code));
+#endif
+
+    /* deferred init running: only static info available */
+    if (!llHdl->ready && !M47_InitFinish(llHdl)) {
+        switch(code) {
+            case M_LL_DEBUG_LEVEL:
+            case M_LL_CH_NUMBER:
+            case M_LL_CH_DIR:
+            case M_LL_CH_LEN:
+            case M_LL_CH_TYP:
+            case M_LL_ID_CHECK:
+            case M_LL_ID_SIZE:
+            case M_LL_BLK_ID_DATA:
+            case M_MK_BLK_REV_ID:
+            case M47_HW_REV:
+            case M47_READY:
+            case M47_BLK_INITSTAT:
+                break;
+            default:
+                return(ERR_LL_DEV_NOTRDY);
+        }
+    }
 
     switch(code)
     {
@@ -1149,18 +2068,13 @@ static int32 M47_GetStat(
         |   ID PROM data            |
         +--------------------------*/
         case M_LL_BLK_ID_DATA:
-        {
-            u_int8 n;
-            u_int16 *dataP = (u_int16*)blk->data;
-
             if (blk->size < MOD_ID_SIZE)        /* check buf size */
                 return(ERR_LL_USERBUF);
 
-            for (n=0; n<MOD_ID_SIZE/2; n++)        /* read MOD_ID_SIZE/2 words */
-                *dataP++ = (u_int16) m_read((U_INT32_OR_64)llHdl->ma, n);
-
+            /* copy read at init */
+            OSS_MemCopy(llHdl->osHdl, MOD_ID_SIZE,
+                        (char*)llHdl->idProm, (char*)blk->data);
             break;
-        }
         /*--------------------------+
         |   ident table pointer     |
         |   (treat as non-block!)   |
@@ -1246,12 +2160,6 @@ static int32 M47_GetStat(
         +---------------------------------------------*/
         case M47_TRANS_MODE_CH:
 
-            /* check module HW Revision */
-            if( llHdl->moduleHwRev < HW_MAJOR_REV_2 ) {
-                error = ERR_LL_ILL_FUNC;
-                break;
-            }
-
             /* check if channel in range */
             if(ch < 0 || ch > 3)
             {
@@ -1287,76 +2195,464 @@ static int32 M47_GetStat(
         +--------------------------*/
         
         case M47_CHECK_CONNECT:
-        
-        MWRITE_D16(llHdl->ma, STATUS_REG, 0x0000);
-        
-        /* Delay for > 2 transmission cycles here 4 msec */
-        OSS_Delay (llHdl->osHdl, 4);  
 
-        *valueP = (int32) ((MREAD_D16(llHdl->ma, STATUS_REG))  & 0x000f);
-        
-        break;
-        
-            
+            /* probe if not monitored */
+            if (!llHdl->connPeriod)
+                M47_ConnectProbe( llHdl );
+
+            *valueP = (int32) llHdl->connMask;
+            break;
 
         /*--------------------------+
-        |  (unknown)                |
+        |  connection monitoring    |
         +--------------------------*/
-        default:
-            error = ERR_LL_UNK_CODE;
-    }
+        case M47_CONNECT_AGE:
+        {
+            int64 age;
 
-    return(error);
-}
+            OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+            age = llHdl->connValid ?
+                M47_Div64( (int64)(M47_TimeUs(llHdl) - llHdl->connStamp),
+                           1000 ) : -1;
+            OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
 
-/******************************* M47_BlockRead *******************************
- *
- *  Description:  Read a data block (values of channels 0..3) from the device.
- *                The variable buf must be a pointer to unsigned long (u_int32)
- *                array with space for 4 values. The location of data in the
- *                buffer is shown below.
- *
- *                    buf[0]      buf[1]       buf[2]       buf[3]
- *                +-------------------------------------------------+
- *                |   value   |    value   |    value   |   value   |
- *                | channel 0 |  channel 1 |  channel 2 | channel 3 |
- *                +-------------------------------------------------+
- *---------------------------------------------------------------------------
- *  Input......:  llHdl        low-level handle
- *                ch           current channel
- *                buf          data buffer
- *                size         data buffer size
- *  Output.....:  nbrRdBytesP  number of read bytes
- *                return       success (0) or error code
- *  Globals....:  ---
- ****************************************************************************/
-static int32 M47_BlockRead(
-     LL_HANDLE *llHdl,
-     int32     ch,
-     void      *buf,
-     int32     size,
-     int32     *nbrRdBytesP
-)
-{
-    int32 i;
-    u_int32* bufPointer;
-    
-    DBGWRT_1((DBH, "LL - M47_BlockRead: ch=%d, size=%d\n",ch,size));
-    
-    bufPointer = (u_int32*) buf;
+            *valueP = M47_Sat32( age );
+            break;
+        }
 
-    if (size < (4 * sizeof(u_int32)))
-    {
-        *nbrRdBytesP = 0;
-        return (ERR_LL_USERBUF);
-    }
-    
-    for ( i = 0; i < 4; i++)
-    {
-        M47_Read (llHdl, i, (int32*)bufPointer++);
-    }
+        case M47_CONNECT_PERIOD:
+            *valueP = (int32) llHdl->connPeriod;
+            break;
 
-    /* return number of read bytes */
+        /*--------------------------+
+        |  FIFO read timeout        |
+        +--------------------------*/
+        case M47_READ_TIMEOUT:
+            *valueP = (int32) llHdl->readTimeout;
+            break;
+
+        /*--------------------------+
+        |  data valid detection     |
+        +--------------------------*/
+        case M47_VALID_TIMEOUT:
+            *valueP = (int32) llHdl->validTimeout;
+            break;
+
+        /*--------------------------+
+        |  loaded PLD bitstream     |
+        +--------------------------*/
+        case M47_FLEX_HASH:
+            *valueP = (int32) llHdl->flexHash;
+            break;
+        /*--------------------------+
+        |  deferred init done       |
+        +--------------------------*/
+        case M47_READY:
+            *valueP = llHdl->ready ? 1 : 0;
+            break;
+
+        case M47_CFG_GEN:
+        case M47_WAIT_VALID:
+        {
+            u_int32 gen;
+
+            if(ch < 0 || ch > 3)
+            {
+                error = ERR_LL_ILL_CHAN;
+                break;
+            }
+
+            if (code == M47_WAIT_VALID)
+                error = M47_WaitValid( llHdl, ch, &gen );
+            else
+                gen = llHdl->cfgGen[ch];
+
+            *valueP = (int32) gen;
+            break;
+        }
+
+        /*--------------------------+
+        |  M_getblock mode          |
+        +--------------------------*/
+        case M47_BLKRD_MODE:
+            *valueP = (int32) llHdl->blkRdMode;
+            break;
+
+        /*--------------------------+
+        |  vectored read channels   |
+        +--------------------------*/
+        case M47_READ_MASK:
+            *valueP = (int32) llHdl->readMask;
+            break;
+
+        /*--------------------------+
+        |  background sampling      |
+        +--------------------------*/
+        case M47_SAMPLE_PERIOD:
+            *valueP = (int32) llHdl->samplePeriod;
+            break;
+
+        /*--------------------------+
+        |  ring buffer state        |
+        +--------------------------*/
+        case M47_FIFO_COUNT:
+        case M47_FIFO_OVERRUN:
+
+            /* check if channel in range */
+            if(ch < 0 || ch > 3)
+            {
+                error = ERR_LL_ILL_CHAN;
+                break;
+            }
+
+            OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+            *valueP = (int32) (code == M47_FIFO_COUNT ?
+                               llHdl->ring[ch].count :
+                               llHdl->ring[ch].overrun);
+            OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+            break;
+
+        /*--------------------------+
+        |  consistent read mode     |
+        +--------------------------*/
+        case M47_CONSISTENT_READ:
+            *valueP = (int32) llHdl->consistRead;
+            break;
+
+        /*--------------------------+
+        |  tear counter             |
+        +--------------------------*/
+        case M47_TEAR_COUNT:
+
+            /* check if channel in range */
+            if(ch < 0 || ch > 3)
+            {
+                error = ERR_LL_ILL_CHAN;
+                break;
+            }
+
+            *valueP = (int32) llHdl->tearCount[ch];
+            break;
+
+        /*--------------------------+
+        |  glitch filter            |
+        +--------------------------*/
+        case M47_GLITCH_LIMIT:
+        case M47_GLITCH_COUNT:
+
+            /* check if channel in range */
+            if(ch < 0 || ch > 3)
+            {
+                error = ERR_LL_ILL_CHAN;
+                break;
+            }
+
+            *valueP = (int32) (code == M47_GLITCH_LIMIT ?
+                               llHdl->glitchLimit[ch] :
+                               llHdl->glitchCount[ch]);
+            break;
+
+        /*--------------------------+
+        |  continuous positions     |
+        +--------------------------*/
+        case M47_BLK_POS64:
+        {
+            int32 i;
+
+            if (blk->size < CH_NUMBER * (int32)sizeof(int64))
+                return(ERR_LL_USERBUF);
+
+            OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+            for (i = 0; i < CH_NUMBER; i++)
+                ((int64*)blk->data)[i] = llHdl->pos[i];
+            OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+
+            blk->size = CH_NUMBER * sizeof(int64);
+            break;
+        }
+
+        /*--------------------------+
+        |  velocity / acceleration  |
+        +--------------------------*/
+        case M47_VELOCITY:
+        case M47_ACCEL:
+
+            /* check if channel in range */
+            if(ch < 0 || ch > 3)
+            {
+                error = ERR_LL_ILL_CHAN;
+                break;
+            }
+
+            M47_Unwrap( llHdl, ch, M47_ReadData( llHdl, ch ) );
+
+            OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+            *valueP = M47_Sat32( code == M47_VELOCITY ?
+                                 llHdl->vel[ch] : llHdl->acc[ch] );
+            OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+            break;
+
+        case M47_MOTION_WINDOW:
+            *valueP = (int32) llHdl->motionWin;
+            break;
+
+        case M47_BLK_INITSTAT:
+        {
+            M47_INITSTAT *stat = (M47_INITSTAT*)blk->data;
+            int32        i;
+
+            if (blk->size < (int32)sizeof(M47_INITSTAT))
+                return(ERR_LL_USERBUF);
+
+            for (i = 0; i < M47_INIT_PHASES; i++) {
+                stat->us[i]     = llHdl->initUs[i];
+                stat->access[i] = llHdl->initAcc[i];
+            }
+            stat->resUs    = llHdl->usPerTick;
+            stat->deferred = llHdl->initDeferred;
+
+            blk->size = sizeof(M47_INITSTAT);
+            break;
+        }
+
+        case M47_BLK_CONFIG:
+        {
+            M47_CONFIG *cfg = (M47_CONFIG*)blk->data;
+            int32      i;
+
+            if (blk->size < (int32)sizeof(M47_CONFIG))
+                return(ERR_LL_USERBUF);
+
+            for (i = 0; i < CH_NUMBER; i++) {
+                cfg->ch[i].baudRate  = llHdl->options[i].baudRate;
+                cfg->ch[i].dataWidth = llHdl->options[i].dataWidth;
+                cfg->ch[i].transMode = llHdl->options[i].transMode;
+            }
+
+            blk->size = sizeof(M47_CONFIG);
+            break;
+        }
+
+        case M47_BLK_MOTION:
+        {
+            M47_MOTION   *motP = (M47_MOTION*)blk->data;
+            M47_HIST_ENT *ent;
+            int32        i;
+
+            if (blk->size < CH_NUMBER * (int32)sizeof(M47_MOTION))
+                return(ERR_LL_USERBUF);
+
+            for (i = 0; i < CH_NUMBER; i++)
+                M47_Unwrap( llHdl, i, M47_ReadData( llHdl, i ) );
+
+            OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+            for (i = 0; i < CH_NUMBER; i++, motP++) {
+                ent = &llHdl->hist[i][llHdl->histIdx[i]];
+                motP->pos   = llHdl->pos[i];
+                motP->vel   = llHdl->vel[i];
+                motP->acc   = llHdl->acc[i];
+                motP->stamp = llHdl->histCnt[i] ? ent->stamp : 0;
+            }
+            OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+
+            blk->size = CH_NUMBER * sizeof(M47_MOTION);
+            break;
+        }
+            
+
+        /*--------------------------+
+        |  (unknown)                |
+        +--------------------------*/
+        default:
+            error = ERR_LL_UNK_CODE;
+    }
+
+    return(error);
+}
+
+/******************************* M47_BlockRead *******************************
+ *
+ *  Description:  Read a data block from the device.
+ *
+ *                M47_BLKRD_SNAPSHOT mode (default):
+ *                Read the values of channels 0..3.
+ *                The variable buf must be a pointer to unsigned long (u_int32)
+ *                array with space for 4 values. The location of data in the
+ *                buffer is shown below.
+ *
+ *                    buf[0]      buf[1]       buf[2]       buf[3]
+ *                +-------------------------------------------------+
+ *                |   value   |    value   |    value   |   value   |
+ *                | channel 0 |  channel 1 |  channel 2 | channel 3 |
+ *                +-------------------------------------------------+
+ *
+ *                M47_BLKRD_POS64 mode:
+ *                Read channels 0..3 and return their continuous
+ *                (unwrapped) positions as int64[4]. See M47_Unwrap().
+ *                The other modes don't update the positions.
+ *
+ *                M47_BLKRD_COHERENT mode:
+ *                Read channels 0..3 with minimal skew and return an
+ *                M47_SNAPSHOT. See M47_Snapshot().
+ *
+ *                M47_BLKRD_FLAGGED mode:
+ *                Read channels 0..3 and return an M47_FSAMPLE[4] with
+ *                the data word and the M47_SMP_xxx flags of each
+ *                channel. See M47_FlaggedRead().
+ *
+ *                M47_BLKRD_VECTOR mode:
+ *                Read the M47_READ_MASK channels as many times as fit
+ *                into size. Each sample is a sequence number followed by
+ *                the data words of the channels (u_int32), channels
+ *                ascending. E.g. mask 0x05, size 36:
+ *
+ *                    buf[0] buf[1] buf[2] buf[3] buf[4] buf[5] ...
+ *                   +--------------------------------------------------+
+ *                   | seq  | CH0  | CH2  | seq+1| CH0  | CH2  | ...    |
+ *                   +--------------------------------------------------+
+ *                   sample 0             sample 1             sample 2
+ *
+ *                Each sample holds a new frame of every channel, so the
+ *                call takes about one frame time per sample.
+ *                See M47_VectorRead().
+ *
+ *                M47_BLKRD_FIFO / M47_BLKRD_FIFO_TS mode:
+ *                Drain the ring buffer of the current channel. buf is
+ *                filled with as many M47_SAMPLE / M47_TSAMPLE records
+ *                (oldest first) as are buffered and fit into size. If no sample is buffered,
+ *                the function waits up to M47_READ_TIMEOUT ms for the next
+ *                sample (0 = don't wait, return 0 bytes).
+ *                Gaps in the sequence numbers indicate lost samples
+ *                (see M47_FIFO_OVERRUN).
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl        low-level handle
+ *                ch           current channel
+ *                buf          data buffer
+ *                size         data buffer size
+ *  Output.....:  nbrRdBytesP  number of read bytes
+ *                return       success (0) or error code
+ *  Globals....:  ---
+ ****************************************************************************/
+static int32 M47_BlockRead(
+     LL_HANDLE *llHdl,
+     int32     ch,
+     void      *buf,
+     int32     size,
+     int32     *nbrRdBytesP
+)
+{
+#ifndef M47_FAST
+    int32 i;
+#endif
+    u_int32* bufPointer;
+    
+#ifndef M47_FAST
+    DBGWRT_1((DBH, "LL - M47_BlockRead: ch=%d, size=%d\n",ch,size));
+#endif
+    
+    bufPointer = (u_int32*) buf;
+
+    if (!llHdl->ready && !M47_InitFinish(llHdl)) {
+        *nbrRdBytesP = 0;
+        return(ERR_LL_DEV_NOTRDY);
+    }
+
+    /* drain ring buffer */
+    if (llHdl->blkRdMode == M47_BLKRD_FIFO ||
+        llHdl->blkRdMode == M47_BLKRD_FIFO_TS)
+        return( M47_FifoRead( llHdl, ch, buf, size, nbrRdBytesP ) );
+
+    /* coherent snapshot */
+    if (llHdl->blkRdMode == M47_BLKRD_COHERENT)
+    {
+        if (size < (int32)sizeof(M47_SNAPSHOT))
+        {
+            *nbrRdBytesP = 0;
+            return (ERR_LL_USERBUF);
+        }
+
+        M47_Snapshot( llHdl, (M47_SNAPSHOT*)buf );
+
+        *nbrRdBytesP = sizeof(M47_SNAPSHOT);
+        return(ERR_SUCCESS);
+    }
+
+    /* samples with flags */
+    if (llHdl->blkRdMode == M47_BLKRD_FLAGGED)
+    {
+        if (size < CH_NUMBER * (int32)sizeof(M47_FSAMPLE))
+        {
+            *nbrRdBytesP = 0;
+            return (ERR_LL_USERBUF);
+        }
+
+        M47_FlaggedRead( llHdl, (M47_FSAMPLE*)buf );
+
+        *nbrRdBytesP = CH_NUMBER * sizeof(M47_FSAMPLE);
+        return(ERR_SUCCESS);
+    }
+
+    /* consecutive samples of selected channels */
+    if (llHdl->blkRdMode == M47_BLKRD_VECTOR)
+        return( M47_VectorRead( llHdl, bufPointer, size, nbrRdBytesP ) );
+
+    /* continuous positions */
+    if (llHdl->blkRdMode == M47_BLKRD_POS64)
+    {
+        int32 n;
+        int64 *posP = (int64*)buf;
+
+        if (size < CH_NUMBER * (int32)sizeof(int64))
+        {
+            *nbrRdBytesP = 0;
+            return (ERR_LL_USERBUF);
+        }
+
+        for (n = 0; n < CH_NUMBER; n++)
+            M47_Unwrap( llHdl, n, M47_ReadData( llHdl, n ) );
+
+        OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+        for (n = 0; n < CH_NUMBER; n++)
+            posP[n] = llHdl->pos[n];
+        OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+
+        *nbrRdBytesP = CH_NUMBER * sizeof(int64);
+        return(ERR_SUCCESS);
+    }
+
+    if (size < (4 * sizeof(u_int32)))
+    {
+        *nbrRdBytesP = 0;
+        return (ERR_LL_USERBUF);
+    }
+    
+#ifndef M47_FAST
+    for ( i = 0; i < 4; i++)
+    {
+        M47_Read (llHdl, i, (int32*)bufPointer++);
+    }
+#else
+    /* no M47_Read per channel: checks and debug output done once */
+    if (llHdl->consistRead ||
+        (llHdl->swGray[0] | llHdl->swGray[1] |
+         llHdl->swGray[2] | llHdl->swGray[3]))
+    {
+        bufPointer[0] = M47_ReadData( llHdl, 0 );
+        bufPointer[1] = M47_ReadData( llHdl, 1 );
+        bufPointer[2] = M47_ReadData( llHdl, 2 );
+        bufPointer[3] = M47_ReadData( llHdl, 3 );
+    }
+    else
+    {
+        /* channel numbers and offsets folded, no reader call */
+        M47_FAST_DATA( llHdl->ma, 0, llHdl->dataBytes[0], bufPointer[0] );
+        M47_FAST_DATA( llHdl->ma, 1, llHdl->dataBytes[1], bufPointer[1] );
+        M47_FAST_DATA( llHdl->ma, 2, llHdl->dataBytes[2], bufPointer[2] );
+        M47_FAST_DATA( llHdl->ma, 3, llHdl->dataBytes[3], bufPointer[3] );
+    }
+#endif
+
+    /* return number of read bytes */
     *nbrRdBytesP = 16;
 
     return(ERR_SUCCESS);
@@ -1396,7 +2692,10 @@ static int32 M47_BlockWrite(
  *
  *  Description:  Interrupt service routine
  *
- *                Unused - the module supports no interrupt.
+ *                Unused - the M47 interrupt enable and acknowledge are not
+ *                documented, so the driver requests no interrupt (USE_IRQ).
+ *                The simulated frame-complete interrupt is handled by
+ *                M47_IrqSimAlarm.
  *
  *---------------------------------------------------------------------------
  *  Input......:  llHdl    ll handle
@@ -1570,9 +2869,36 @@ static int32 Cleanup(
    int32        retCode     /* nodoc */
 )
 {
+    int32 i;
+
     /*------------------------------+
     |  close handles                |
     +------------------------------*/
+    /* clean up deferred init alarm */
+    if (llHdl->initAlarmHdl)
+        OSS_AlarmRemove(llHdl->osHdl, &llHdl->initAlarmHdl);
+
+    /* clean up sampling alarm */
+    if (llHdl->alarmHdl)
+        OSS_AlarmRemove(llHdl->osHdl, &llHdl->alarmHdl);
+
+    /* clean up connection monitor */
+    if (llHdl->connAlarmHdl)
+        OSS_AlarmRemove(llHdl->osHdl, &llHdl->connAlarmHdl);
+
+    /* clean up simulated interrupt source */
+    if (llHdl->irqSimAlarmHdl)
+        OSS_AlarmRemove(llHdl->osHdl, &llHdl->irqSimAlarmHdl);
+
+    /* clean up reader semaphores */
+    for (i = 0; i < CH_NUMBER; i++)
+        if (llHdl->readSemHdl[i])
+            OSS_SemRemove(llHdl->osHdl, &llHdl->readSemHdl[i]);
+
+    /* clean up spin lock */
+    if (llHdl->lockHdl)
+        OSS_SpinLockRemove(llHdl->osHdl, &llHdl->lockHdl);
+
     /* clean up desc */
     if (llHdl->descHdl)
         DESC_Exit(&llHdl->descHdl);
@@ -1583,6 +2909,10 @@ static int32 Cleanup(
     /*------------------------------+
     |  free memory                  |
     +------------------------------*/
+    /* free ring buffers */
+    if (llHdl->ringMem)
+        OSS_MemFree(llHdl->osHdl, (int8*)llHdl->ringMem, llHdl->ringAlloc);
+
     /* free my handle */
     OSS_MemFree(llHdl->osHdl, (int8*)llHdl, llHdl->memAlloc);
 
@@ -1609,45 +2939,1922 @@ static char* M47_FlexDataIdent( void )  /* nodoc */
     return( (char*)M47_FlexIdent );
 }
 
-/*************************  M47_UpdateControlRegs  ****************************
+/***************************  M47_FlexPldRev  *******************************
  *
- *  Description:  Update control registers for all channels.
- *                After setting the registers this function waits for 1600 us
+ *  Description:  Get the PLD revision of the built-in flex data.
  *
+ *                The revision is taken from the bitstream name
+ *                "m47_<major>r<minor>.bin" in the ident string. The PLD
+ *                reports <minor> in bits 3..0 of MODE_REV_CH0.
  *
  *---------------------------------------------------------------------------
- *  Input......:  llHdl     low-level handle
+ *  Input......:  -
  *
- *  Output.....:  -
+ *  Output.....:  return  PLD revision, 0xffffffff if unknown
  *
  *  Globals....:  -
  ****************************************************************************/
-static void M47_UpdateControlRegs( LL_HANDLE *llHdl ) /* nodoc */
+static u_int32 M47_FlexPldRev( void ) /* nodoc */
 {
-    
-    MWRITE_D16(llHdl->ma, CONTREG_CH0, ((llHdl->options[0].baudRate) | 
-    (llHdl->options[0].dataWidth << 2)));
-
-    MWRITE_D16(llHdl->ma, CONTREG_CH1, ((llHdl->options[1].baudRate) | 
-    (llHdl->options[1].dataWidth << 2)));
-    
-    MWRITE_D16(llHdl->ma, CONTREG_CH2, ((llHdl->options[2].baudRate) | 
-    (llHdl->options[2].dataWidth << 2)));
-
-    MWRITE_D16(llHdl->ma, CONTREG_CH3, ((llHdl->options[3].baudRate) | 
-    (llHdl->options[3].dataWidth << 2)));    
-
-    DBGWRT_3((DBH, "LL - M47_UpdateControlRegs: CONTREG_CH0 = 0x%04x\n",
-                   MREAD_D16(llHdl->ma, CONTREG_CH0)));
-
-    DBGWRT_3((DBH, "LL - M47_UpdateControlRegs: CONTREG_CH1 = 0x%04x\n",
-                   MREAD_D16(llHdl->ma, CONTREG_CH1)));
-
-    DBGWRT_3((DBH, "LL - M47_UpdateControlRegs: CONTREG_CH2 = 0x%04x\n",
-                   MREAD_D16(llHdl->ma, CONTREG_CH2)));
-
-    DBGWRT_3((DBH, "LL - M47_UpdateControlRegs: CONTREG_CH3 = 0x%04x\n",
-                   MREAD_D16(llHdl->ma, CONTREG_CH3)));
+    const char *p;
+    u_int32    rev;
+
+    for (p = M47_FlexIdent + 1; *p; p++) {
+        if (*p == 'r' && p[-1] >= '0' && p[-1] <= '9' &&
+            p[1] >= '0' && p[1] <= '9') {
+            for (rev = 0, p++; *p >= '0' && *p <= '9'; p++)
+                rev = rev * 10 + (*p - '0');
+            return( rev & 0x000f );
+        }
+    }
 
+    return( 0xffffffff );
 }
 
+/**************************  M47_FlexLoadBlob  ******************************
+ *
+ *  Description:  Load a PLD bitstream passed at runtime.
+ *
+ *                The file is checked against its size header and the
+ *                hash in the M47_FLEXBLOB header; a hash of 0 is
+ *                rejected like any other mismatch. A file with the hash
+ *                of the loaded bitstream is not loaded again.
+ *
+ *                While the PLD is configured, the device is not ready and
+ *                background sampling, connection monitoring and the
+ *                interrupt are stopped, so no other path accesses its
+ *                registers. After loading, all channels are reprogrammed
+ *                from the channel options (M47_InitHw) and the stopped
+ *                paths are restarted.
+ *
+ *                Fails with ERR_LL_DEV_NOTRDY while an INIT_DEFERRED
+ *                load is running.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                blk       M47_FLEXBLOB followed by the bitstream file
+ *
+ *  Output.....:  return    success (0) or error code
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static int32 M47_FlexLoadBlob( LL_HANDLE *llHdl, M_SG_BLOCK *blk ) /* nodoc */
+{
+    M47_FLEXBLOB *hdr = (M47_FLEXBLOB*)blk->data;
+    u_int8       *bin = (u_int8*)(hdr + 1);
+    u_int32      size, hash;
+    u_int32      samplePeriod, connPeriod, irqEnabled;
+    int32        error, err2;
+
+    /* don't race a deferred init */
+    if (!llHdl->ready)
+        return(ERR_LL_DEV_NOTRDY);
+
+    if (blk->size < (int32)sizeof(M47_FLEXBLOB) + 4 ||
+        hdr->size != blk->size - sizeof(M47_FLEXBLOB))
+        return(ERR_LL_USERBUF);
+
+    /* size header of the file */
+    size = ((u_int32)bin[0] << 24) | ((u_int32)bin[1] << 16) |
+           ((u_int32)bin[2] <<  8) |  (u_int32)bin[3];
+    if (size != hdr->size - 4)
+        return(ERR_LL_ILL_PARAM);
+
+    hash = M47_FlexHash( bin, hdr->size );
+    if (hdr->hash != hash) {
+        DBGWRT_ERR((DBH, " *** M47_FlexLoadBlob: hash 0x%08x, expected 0x%08x\n",
+                    hash, hdr->hash));
+        return(ERR_LL_ILL_PARAM);
+    }
+
+    if (hash == llHdl->flexHash) {
+        DBGWRT_2((DBH, "LL - M47_FlexLoadBlob: 0x%08x already loaded\n",
+                  hash));
+        return(ERR_SUCCESS);
+    }
+
+    /* stop all paths accessing the registers */
+    samplePeriod = llHdl->samplePeriod;
+    connPeriod   = llHdl->connPeriod;
+    irqEnabled   = llHdl->irqEnabled;
+
+    llHdl->ready = FALSE;
+    M47_IrqEnable( llHdl, FALSE );
+    M47_SampleStart( llHdl, 0 );
+    M47_ConnectStart( llHdl, 0 );
+
+    /* stop transmission */
+    M47_WR16( llHdl, CONTREG_CH0, 0x0000 );
+    if (llHdl->moduleHwRev >= HW_MAJOR_REV_2) {
+        M47_WR16( llHdl, CONTREG_CH1, 0x0000 );
+        M47_WR16( llHdl, CONTREG_CH2, 0x0000 );
+        M47_WR16( llHdl, CONTREG_CH3, 0x0000 );
+    }
+
+    /* 4 JTAG cycles per byte, 3 writes per cycle */
+    M47_FlexLoadRaw( llHdl->ma, bin + 4, size );
+    llHdl->busAcc += 3 * 4 * size;
+    llHdl->flexHash = hash;
+    llHdl->flexLoads++;
+
+    DBGWRT_2((DBH, "LL - M47_FlexLoadBlob: loaded 0x%08x, PLD rev %d\n",
+              hash, M47_RD16( llHdl, MODE_REV_CH0 ) & 0x000f));
+
+    /* register state of the new PLD is unknown, ready afterwards */
+    M47_InitHw( llHdl );
+
+    /* restart stopped paths */
+    error = M47_SampleStart( llHdl, samplePeriod );
+    if ((err2 = M47_ConnectStart( llHdl, connPeriod )) && !error)
+        error = err2;
+    if (irqEnabled && (err2 = M47_IrqEnable( llHdl, TRUE )) && !error)
+        error = err2;
+
+    return(error);
+}
+
+/*****************************  M47_Reconfig  *******************************
+ *
+ *  Description:  Bring the mode and control registers in line with the
+ *                channel options.
+ *
+ *                Only channels whose register values differ from the
+ *                shadows are touched; the others keep running. A changed
+ *                control register stops the channel, clears its data RAM
+ *                and restarts it. On HW revision >= 2, a channel whose
+ *                mode register alone changed keeps running: the new mode
+ *                is written and takes effect with the next frame. The
+ *                frame in flight may still be decoded with the old mode,
+ *                so its transfer bit doesn't count as valid data.
+ *                Below HW revision 2 the CH0 registers serve all channels,
+ *                so every change restarts the whole module.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *
+ *  Output.....:  -
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_Reconfig( LL_HANDLE *llHdl ) /* nodoc */
+{
+    u_int16 cont[CH_NUMBER];
+    u_int16 mode[CH_NUMBER];
+    u_int32 changed = 0;
+    u_int32 restart = 0;
+    int32   ch, nReg, offs;
+
+    nReg = (llHdl->moduleHwRev >= HW_MAJOR_REV_2) ? CH_NUMBER : 1;
+
+    M47_ModeRegs( llHdl, mode );
+
+    for (ch = 0; ch < nReg; ch++) {
+        cont[ch] = (u_int16)(llHdl->options[ch].baudRate |
+                             (llHdl->options[ch].dataWidth << 2));
+        if (cont[ch] != llHdl->contShadow[ch])
+            restart |= 1 << ch;
+        if (cont[ch] != llHdl->contShadow[ch] ||
+            mode[ch] != llHdl->modeShadow[ch])
+            changed |= 1 << ch;
+    }
+
+    /* single mode register: mode changes need a restart, too */
+    if (nReg == 1)
+        restart = changed;
+
+    /* mode only: switch at the next frame, don't stop the channel */
+    if (changed & ~restart) {
+        for (ch = 0; ch < nReg; ch++)
+            if ((changed & ~restart) & (1 << ch))
+                M47_WriteShadow( llHdl, M47_ModeReg[ch],
+                                 &llHdl->modeShadow[ch], mode[ch] );
+
+        M47_ValidReset( llHdl, changed & ~restart, changed & ~restart );
+    }
+
+    if (restart) {
+        /* stop transmission */
+        for (ch = 0; ch < nReg; ch++)
+            if (restart & (1 << ch))
+                M47_WriteShadow( llHdl, M47_ContReg[ch],
+                                 &llHdl->contShadow[ch], 0x0000 );
+
+        /* clear data RAM */
+        if (nReg == 1) {
+            for (offs = 0; offs < DATABUFSIZE * 2; offs += 2)
+                M47_WR16( llHdl, (REG_START + offs), 0x0000 );
+        }
+        else {
+            for (ch = 0; ch < nReg; ch++)
+                if (restart & (1 << ch))
+                    for (offs = 0; offs < 8; offs += 2)
+                        M47_WR16( llHdl,
+                                  (REG_START + DATACH(ch) + offs), 0x0000 );
+        }
+
+        /* old frames are no longer valid */
+        M47_ValidReset( llHdl, nReg == 1 ? (1 << CH_NUMBER) - 1 : restart,
+                        0 );
+
+        /* set mode and restart transmission */
+        for (ch = 0; ch < nReg; ch++) {
+            if (restart & (1 << ch)) {
+                M47_WriteShadow( llHdl, M47_ModeReg[ch],
+                                 &llHdl->modeShadow[ch], mode[ch] );
+                M47_WriteShadow( llHdl, M47_ContReg[ch],
+                                 &llHdl->contShadow[ch], cont[ch] );
+            }
+        }
+    }
+
+    M47_SelectReaders( llHdl );
+
+    DBGWRT_3((DBH, "LL - M47_Reconfig: changed=0x%x restart=0x%x\n"
+                   " CONTREG = %04X %04X %04X %04X\n"
+                   " MODE    = %04X %04X %04X %04X\n", changed, restart,
+                   llHdl->contShadow[0], llHdl->contShadow[1],
+                   llHdl->contShadow[2], llHdl->contShadow[3],
+                   llHdl->modeShadow[0], llHdl->modeShadow[1],
+                   llHdl->modeShadow[2], llHdl->modeShadow[3]));
+}
+
+/***************************  M47_WriteShadow  ******************************
+ *
+ *  Description:  Write a register unless its shadow already holds the value.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                offs      register offset
+ *                shadow    register shadow
+ *                val       value to write
+ *
+ *  Output.....:  -
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_WriteShadow(
+    LL_HANDLE *llHdl,
+    u_int32 offs,
+    u_int16 *shadow,
+    u_int16 val
+) /* nodoc */
+{
+    if (*shadow == val)
+        return;
+
+    M47_WR16( llHdl, offs, val );
+    *shadow = val;
+}
+
+/*****************************  M47_ReadData  *******************************
+ *
+ *  Description:  Read the data word of a channel from the data RAM.
+ *
+ *                Uses the reader selected by M47_SelectReaders() for the
+ *                channel's data width.
+ *
+ *                The data word is assembled from up to four byte
+ *                registers. If the PLD updates the data RAM in between,
+ *                the word is torn. With M47_CONSISTENT_READ, the upper
+ *                bytes are read again after the lowest byte. If they
+ *                changed, the word is counted as torn and read again
+ *                (max. TEAR_RETRY_MAX times).
+ *
+ *                Channels with swGray set (see M47_ModeRegs) are
+ *                Gray decoded. The continuous position is not updated,
+ *                so plain reads take no lock (see M47_Unwrap).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                ch        channel
+ *
+ *  Output.....:  return    data word
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static u_int32 M47_ReadData( LL_HANDLE *llHdl, int32 ch ) /* nodoc */
+{
+    u_int32 data, retry;
+
+    data = llHdl->reader[ch]( llHdl->ma, ch );
+
+    /* single byte can't tear */
+    if (llHdl->consistRead && llHdl->dataBytes[ch] > 1)
+    {
+        for (retry = 0; retry < TEAR_RETRY_MAX; retry++)
+        {
+            if (M47_ReadUpper( llHdl->ma, ch, llHdl->dataBytes[ch] - 1 ) ==
+                (data >> 8))
+                break;
+
+            llHdl->tearCount[ch]++;
+            data = llHdl->reader[ch]( llHdl->ma, ch );
+        }
+    }
+
+    if (llHdl->swGray[ch])
+        data = M47_GrayDecode( data, llHdl->widthMask[ch] );
+
+    return( data );
+}
+
+/***************************  M47_SelectReaders  ****************************
+ *
+ *  Description:  Select the data word reader of all channels.
+ *
+ *                Each byte register of the data RAM costs one bus cycle.
+ *                The reader only accesses the byte registers which can
+ *                hold valid bits for the channel's data width, e.g.
+ *                d15..d0 for a 13-bit encoder.
+ *
+ *                Must be called whenever a data width changes.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *
+ *  Output.....:  -
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_SelectReaders( LL_HANDLE *llHdl ) /* nodoc */
+{
+    static const M47_READER readerTbl[5] = {
+        M47_ReadD0, M47_ReadD8, M47_ReadD16, M47_ReadD24, M47_ReadD32
+    };
+    int32 ch;
+
+    u_int32 mask;
+
+    for (ch = 0; ch < CH_NUMBER; ch++) {
+        mask = llHdl->options[ch].dataWidth ?
+            0xffffffff >> (32 - llHdl->options[ch].dataWidth) : 0;
+
+        /* unwrapping depends on the data width */
+        if (mask != llHdl->widthMask[ch])
+            M47_UnwrapReset( llHdl, ch );
+
+        llHdl->dataBytes[ch] = (llHdl->options[ch].dataWidth + 7) >> 3;
+        llHdl->reader[ch]    = readerTbl[llHdl->dataBytes[ch]];
+        llHdl->widthMask[ch] = mask;
+    }
+}
+
+/*****************************  M47_ReadDxx  ********************************
+ *
+ *  Description:  Data word readers for 0, 8, 16, 24 and 32 valid bits.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  ma        hw access handle
+ *                ch        channel
+ *
+ *  Output.....:  return    data word
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static u_int32 M47_ReadD0( MACCESS ma, int32 ch ) /* nodoc */
+{
+    /* channel disabled */
+    return( 0 );
+}
+
+static u_int32 M47_ReadD8( MACCESS ma, int32 ch ) /* nodoc */
+{
+    /* Read d7..d0 */
+    return( (u_int8) MREAD_D16 (ma, (DATACH(ch) + 0x06)) );
+}
+
+static u_int32 M47_ReadD16( MACCESS ma, int32 ch ) /* nodoc */
+{
+    register u_int32 data;
+
+    /* Read d15..d8 */
+    data  = (u_int8) MREAD_D16 (ma, (DATACH(ch) + 0x04));
+    data <<= 8;
+
+    /* Read d7..d0 */
+    data |= (u_int8) MREAD_D16 (ma, (DATACH(ch) + 0x06));
+
+    return( data );
+}
+
+static u_int32 M47_ReadD24( MACCESS ma, int32 ch ) /* nodoc */
+{
+    register u_int32 data;
+
+    /* Read d23..d16 */
+    data  = (u_int8) MREAD_D16 (ma, (DATACH(ch) + 0x02));
+    data <<= 8;
+
+    /* Read d15..d8 */
+    data |= (u_int8) MREAD_D16 (ma, (DATACH(ch) + 0x04));
+    data <<= 8;
+
+    /* Read d7..d0 */
+    data |= (u_int8) MREAD_D16 (ma, (DATACH(ch) + 0x06));
+
+    return( data );
+}
+
+static u_int32 M47_ReadD32( MACCESS ma, int32 ch ) /* nodoc */
+{
+    register u_int32 data;
+
+    /* Read d31..d24 */
+    data  = (u_int8) MREAD_D16 (ma, DATACH(ch));
+    data <<= 8;
+
+    /* Read d23..d16 */
+    data |= (u_int8) MREAD_D16 (ma, (DATACH(ch) + 0x02));
+    data <<= 8;
+
+    /* Read d15..d8 */
+    data |= (u_int8) MREAD_D16 (ma, (DATACH(ch) + 0x04));
+    data <<= 8;
+
+    /* Read d7..d0 */
+    data |= (u_int8) MREAD_D16 (ma, (DATACH(ch) + 0x06));
+
+    return( data );
+}
+
+/****************************  M47_ReadUpper  *******************************
+ *
+ *  Description:  Read the data bytes above d7..d0 of a channel.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  ma        hw access handle
+ *                ch        channel
+ *                nBytes    number of bytes to read (1..3)
+ *
+ *  Output.....:  return    data word >> 8
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static u_int32 M47_ReadUpper( MACCESS ma, int32 ch, u_int32 nBytes ) /* nodoc */
+{
+    u_int32 data = 0;
+    u_int32 offs = DATACH(ch) + 0x06 - (nBytes << 1);
+
+    /* d31..d24 / d23..d16 / d15..d8, most significant first */
+    while (nBytes--) {
+        data <<= 8;
+        data |= (u_int8) MREAD_D16 (ma, offs);
+        offs += 2;
+    }
+
+    return( data );
+}
+
+/****************************  M47_Snapshot  ********************************
+ *
+ *  Description:  Read all channels as close together as possible.
+ *
+ *                The accesses are ordered by how fast the data changes:
+ *                first the upper bytes of all channels, then d7..d0 of
+ *                all channels back to back, then the upper bytes again.
+ *                The d7..d0 reads define the sampling instant, so the
+ *                skew between the channels is one register access each.
+ *                If an upper byte changed in between, the word is torn
+ *                and the snapshot is repeated (max. M47_SNAP_RETRY_MAX
+ *                times).
+ *
+ *                The reads are done with the spin lock held, so alarms
+ *                and the interrupt can't delay a channel. Each pass takes
+ *                at most 4 * (3 + 1 + 3) = 28 register reads, so the lock
+ *                is held for at most (M47_SNAP_RETRY_MAX + 1) * 28 reads.
+ *
+ *                The system time has tick resolution and can't resolve
+ *                the skew, so no timestamps are returned. skew counts the
+ *                register accesses between the d7..d0 reads of the first
+ *                and the last channel; multiplied by the access time of
+ *                the carrier, it bounds the time between the channels.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *
+ *  Output.....:  snap      snapshot
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_Snapshot( LL_HANDLE *llHdl, M47_SNAPSHOT *snap ) /* nodoc */
+{
+    MACCESS ma = llHdl->ma;
+    u_int32 upper[CH_NUMBER];
+    u_int32 data, torn, nUp, nLow = 0;
+    int32   ch;
+
+    snap->retries = 0;
+
+    OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+
+    for (;;) {
+        /* slowly changing bytes */
+        for (ch = 0; ch < CH_NUMBER; ch++) {
+            nUp = llHdl->dataBytes[ch] ? llHdl->dataBytes[ch] - 1 : 0;
+            upper[ch] = nUp ? M47_ReadUpper( ma, ch, nUp ) : 0;
+        }
+
+        /* sampling instant */
+        for (ch = 0, nLow = 0; ch < CH_NUMBER; ch++) {
+            if (llHdl->dataBytes[ch]) {
+                snap->value[ch] = M47_ReadD8( ma, ch );
+                nLow++;
+            }
+            else
+                snap->value[ch] = 0;
+        }
+
+        /* torn words? */
+        for (ch = 0, torn = 0; ch < CH_NUMBER; ch++) {
+            nUp = llHdl->dataBytes[ch] ? llHdl->dataBytes[ch] - 1 : 0;
+            if (nUp && M47_ReadUpper( ma, ch, nUp ) != upper[ch]) {
+                llHdl->tearCount[ch]++;
+                torn = TRUE;
+            }
+        }
+
+        if (!torn || snap->retries == M47_SNAP_RETRY_MAX)
+            break;
+        snap->retries++;
+    }
+
+    OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+
+    snap->skew = nLow ? nLow - 1 : 0;
+
+    for (ch = 0; ch < CH_NUMBER; ch++) {
+        data = (upper[ch] << 8) | snap->value[ch];
+
+        if (llHdl->swGray[ch])
+            data = M47_GrayDecode( data, llHdl->widthMask[ch] );
+
+        snap->value[ch] = data;
+    }
+}
+
+/**************************  M47_FlaggedRead  *******************************
+ *
+ *  Description:  Read all channels and flag the state of their data.
+ *
+ *                The transfer bits of the Status Register are taken and
+ *                cleared before the data RAM is read, so a frame flagged
+ *                as fresh is contained in the data word. Bits taken by
+ *                the connection monitor or M47_Reconfig in between are collected in freshSeen.
+ *
+ *                M47_SMP_FRESH    a frame completed since the last
+ *                                 flagged read
+ *                M47_SMP_VALID    a frame with the current configuration
+ *                                 completed (not the cleared data RAM)
+ *                M47_SMP_STALE    no frame for M47_STALE_FRAMES frame
+ *                                 times (plus one system tick)
+ *                M47_SMP_DISCONN  no frame for M47_VALID_TIMEOUT
+ *                                 (never set if 0)
+ *
+ *                The frame age is measured from the flagged read that saw
+ *                the frame. Disabled channels (data width 0) get no flags.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *
+ *  Output.....:  smp       samples of channels 0..3
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_FlaggedRead( LL_HANDLE *llHdl, M47_FSAMPLE *smp ) /* nodoc */
+{
+    u_int16 status;
+    u_int32 bits, bit, flags;
+    u_int64 now, age;
+    int32   ch;
+
+    status = MREAD_D16(llHdl->ma, STATUS_REG);
+    MWRITE_D16(llHdl->ma, STATUS_REG, 0x0000);
+
+    for (ch = 0; ch < CH_NUMBER; ch++)
+        smp[ch].value = M47_ReadData( llHdl, ch );
+
+    OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+    now  = M47_TimeUs( llHdl );
+    bits = (llHdl->freshSeen | status) & STATUS_TRANSFER;
+    llHdl->freshSeen  = 0;
+    llHdl->connSeen  |= status & STATUS_TRANSFER;
+    M47_FrameSeen( llHdl, status );
+
+    for (ch = 0; ch < CH_NUMBER; ch++) {
+        bit   = 1 << ch;
+        flags = 0;
+
+        if (llHdl->options[ch].dataWidth) {
+            if (bits & bit) {
+                flags |= M47_SMP_FRESH;
+                llHdl->frameStamp[ch] = now;
+            }
+
+            if (llHdl->frameSeen & bit)
+                llHdl->validMask |= bit;
+            if (llHdl->validMask & bit)
+                flags |= M47_SMP_VALID;
+
+            age = now - llHdl->frameStamp[ch];
+            if (age > (u_int64)M47_STALE_FRAMES *
+                      M47_FrameTimeUs( llHdl, ch ) + llHdl->usPerTick)
+                flags |= M47_SMP_STALE;
+            if (llHdl->validTimeout &&
+                age >= (u_int64)llHdl->validTimeout * 1000)
+                flags |= M47_SMP_DISCONN;
+        }
+
+        smp[ch].flags = flags;
+    }
+    OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+}
+
+/**************************  M47_VectorRead  ********************************
+ *
+ *  Description:  Read consecutive samples of the M47_READ_MASK channels.
+ *
+ *                Each sample is a sequence number (vecSeq) followed by
+ *                the data words of the selected channels. Before each
+ *                sample, the function polls the Status Register every
+ *                VECTOR_POLL_US until each selected channel completed a
+ *                new frame since its last vector sample (also in an
+ *                earlier call). So consecutive samples never repeat a
+ *                frame. Disabled channels (data width 0) are read but
+ *                not waited for.
+ *
+ *                The transfer bits are taken right before the data words
+ *                are read. If a frame of a selected channel completes
+ *                during the reads, it may be half contained, so the
+ *                sample is read again (max. TEAR_RETRY_MAX times).
+ *
+ *                The device stays locked while polling, so the call
+ *                blocks the device for about one frame time of the
+ *                slowest selected channel per sample. If a channel
+ *                delivers no frame within M47_STALE_FRAMES frame times,
+ *                the samples read so far are returned, or
+ *                ERR_OSS_TIMEOUT if there are none.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl        low-level handle
+ *                buf          data buffer
+ *                size         data buffer size
+ *
+ *  Output.....:  nbrRdBytesP  number of read bytes
+ *                return       success (0) or error code
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static int32 M47_VectorRead(
+    LL_HANDLE *llHdl,
+    u_int32 *buf,
+    int32 size,
+    int32 *nbrRdBytesP
+) /* nodoc */
+{
+    int32   chList[CH_NUMBER];
+    int32   n, nCh = 0, samples, done, retry;
+    u_int32 want = 0, limitUs = 0, waited, seen;
+
+    for (n = 0; n < CH_NUMBER; n++) {
+        if (!(llHdl->readMask & (1 << n)))
+            continue;
+
+        chList[nCh++] = n;
+        if (llHdl->options[n].dataWidth) {
+            want |= 1 << n;
+            if (limitUs < M47_FrameTimeUs( llHdl, n ))
+                limitUs = M47_FrameTimeUs( llHdl, n );
+        }
+    }
+    limitUs *= M47_STALE_FRAMES;
+
+    samples = size / ((nCh + 1) * (int32)sizeof(u_int32));
+    if (!samples) {
+        *nbrRdBytesP = 0;
+        return(ERR_LL_USERBUF);
+    }
+
+    for (done = 0; done < samples; done++) {
+        /* wait for a new frame of each channel */
+        for (waited = 0; ; waited += VECTOR_POLL_US) {
+            seen = M47_VectorSeen( llHdl, 0 ) & want;
+            if (seen == want || waited >= limitUs)
+                break;
+            OSS_MikroDelay( llHdl->osHdl, VECTOR_POLL_US );
+        }
+
+        if (seen != want) {
+            DBGWRT_ERR((DBH, " *** M47_VectorRead: no frame, CH mask 0x%x\n",
+                        want & ~seen));
+            break;
+        }
+
+        /* take the frames, re-read if one completes meanwhile */
+        for (retry = 0; ; retry++) {
+            M47_VectorSeen( llHdl, want );
+
+            for (n = 0; n < nCh; n++)
+                buf[n + 1] = M47_ReadData( llHdl, chList[n] );
+
+            if (!(M47_VectorSeen( llHdl, 0 ) & want) ||
+                retry == TEAR_RETRY_MAX)
+                break;
+        }
+
+        buf[0] = llHdl->vecSeq++;
+        buf   += nCh + 1;
+    }
+
+    *nbrRdBytesP = done * (nCh + 1) * sizeof(u_int32);
+
+    return( done ? ERR_SUCCESS : ERR_OSS_TIMEOUT );
+}
+
+/**************************  M47_VectorSeen  ********************************
+ *
+ *  Description:  Take the transfer bits for M47_VectorRead.
+ *
+ *                The Status Register is read and acknowledged; the bits
+ *                are passed on to the connection monitor, the sample
+ *                flags and the data valid logic like in M47_WaitValid.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                clear     channels whose frames are taken now
+ *
+ *  Output.....:  return    channels with a new frame since their last
+ *                          vector sample (before clearing)
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static u_int32 M47_VectorSeen( LL_HANDLE *llHdl, u_int32 clear ) /* nodoc */
+{
+    u_int16 status;
+    u_int32 seen;
+
+    status = MREAD_D16(llHdl->ma, STATUS_REG);
+    MWRITE_D16(llHdl->ma, STATUS_REG, 0x0000);
+
+    OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+    llHdl->connSeen  |= status & STATUS_TRANSFER;
+    llHdl->freshSeen |= status & STATUS_TRANSFER;
+    M47_FrameSeen( llHdl, status );
+    seen = llHdl->vecSeen;
+    llHdl->vecSeen &= ~clear;
+    OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+
+    return( seen );
+}
+
+/****************************  M47_ModeRegs  ********************************
+ *
+ *  Description:  Compute the mode register values from the channel options.
+ *
+ *                HW revision >= 2 has a mode register per channel.
+ *
+ *                Below HW revision 2 only MODE_REV_CH0 exists and sets the
+ *                mode of all channels. If the channels use different
+ *                modes, the hardware is set to binary (raw sensor bits)
+ *                and the Gray channels are decoded in software.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *
+ *  Output.....:  mode      register values, one per channel
+ *                          (only mode[0] below HW revision 2)
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_ModeRegs( LL_HANDLE *llHdl, u_int16 *mode ) /* nodoc */
+{
+    u_int16 hwMode = llHdl->options[0].transMode;
+    int32   ch;
+
+    if( llHdl->moduleHwRev >= HW_MAJOR_REV_2 ) {
+        for (ch = 0; ch < CH_NUMBER; ch++) {
+            mode[ch] = (u_int16)(llHdl->options[ch].transMode << 7);
+            llHdl->swGray[ch] = FALSE;
+        }
+        return;
+    }
+
+    /* mixed modes? */
+    for (ch = 1; ch < CH_NUMBER; ch++)
+        if (llHdl->options[ch].transMode != hwMode)
+            hwMode = M47_TRANS_MODE_BIN;
+
+    for (ch = 0; ch < CH_NUMBER; ch++)
+        llHdl->swGray[ch] = (llHdl->options[ch].transMode != hwMode);
+
+    mode[0] = (u_int16)(hwMode << 7);
+
+    DBGWRT_2((DBH, "LL - M47_ModeRegs: hw mode %d, sw Gray %d%d%d%d\n",
+              hwMode, llHdl->swGray[0], llHdl->swGray[1],
+              llHdl->swGray[2], llHdl->swGray[3]));
+}
+
+/****************************  M47_GrayDecode  ******************************
+ *
+ *  Description:  Convert a Gray coded data word to binary.
+ *
+ *                Each binary bit is the XOR of all Gray bits above and
+ *                including it. The prefix XOR takes five shift steps for
+ *                32 bits, independent of the data.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  data      Gray coded data word
+ *                mask      valid data bits
+ *
+ *  Output.....:  return    binary data word
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static u_int32 M47_GrayDecode( u_int32 data, u_int32 mask ) /* nodoc */
+{
+    data &= mask;
+
+    data ^= data >> 1;
+    data ^= data >> 2;
+    data ^= data >> 4;
+    data ^= data >> 8;
+    data ^= data >> 16;
+
+    return( data );
+}
+
+/******************************  M47_Unwrap  ********************************
+ *
+ *  Description:  Update the continuous position of a channel.
+ *
+ *                The data word wraps at 2^dataWidth. The difference to
+ *                the previous data word is sign extended from dataWidth
+ *                bits and added to the 64-bit position, so moves of less
+ *                than half a turn between two reads are tracked.
+ *                The first data word after M47_UnwrapReset() is taken as
+ *                position.
+ *
+ *                Only called by the paths that deliver positions or
+ *                motion: M47_BLKRD_POS64 reads, the M47_BLK_POS64 preset,
+ *                the motion getstats and M47_Acquire. Between two of
+ *                them, the encoder must move less than half a turn.
+ *
+ *                If the channel's glitch filter is on, a difference the
+ *                encoder can't have moved since the last good data word
+ *                (see M47_Glitch) leaves position and motion unchanged.
+ *                The filter only acts here: data words returned by reads
+ *                and buffered by M47_Acquire are never filtered.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                ch        channel
+ *                data      data word
+ *
+ *  Output.....:  -
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_Unwrap( LL_HANDLE *llHdl, int32 ch, u_int32 data ) /* nodoc */
+{
+    u_int32 shift = 32 - llHdl->options[ch].dataWidth;
+    int32   delta;
+
+    /* channel disabled */
+    if (shift == 32)
+        return;
+
+    OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+
+    if (llHdl->posValid[ch]) {
+        delta = (int32)((data - llHdl->posRaw[ch]) << shift) >> shift;
+
+        if (llHdl->glitchLimit[ch] && M47_Glitch( llHdl, ch, delta )) {
+            OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+            return;
+        }
+        llHdl->pos[ch] += delta;
+    }
+    else {
+        llHdl->pos[ch]         = data;
+        llHdl->glitchRun[ch]   = 0;
+        llHdl->glitchStamp[ch] = M47_TimeUs( llHdl );
+    }
+
+    llHdl->posRaw[ch]   = data;
+    llHdl->posValid[ch] = TRUE;
+
+    M47_Motion( llHdl, ch );
+
+    OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+}
+
+/******************************  M47_Glitch  ********************************
+ *
+ *  Description:  Check a data word difference against the glitch limit.
+ *
+ *                The difference is allowed if the encoder can reach it
+ *                at glitchLimit counts/s within the time since the last
+ *                good data word plus one tick (timestamp resolution).
+ *                After GLITCH_RUN_MAX rejections in a row, the next
+ *                difference is accepted, so a real jump (e.g. encoder
+ *                exchanged) is followed.
+ *
+ *                Must be called with the spin lock held.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                ch        channel
+ *                delta     difference to the last good data word
+ *
+ *  Output.....:  return    TRUE if the data word is rejected
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static int32 M47_Glitch( LL_HANDLE *llHdl, int32 ch, int32 delta ) /* nodoc */
+{
+    u_int64 now = M47_TimeUs( llHdl );
+    u_int64 dt  = now - llHdl->glitchStamp[ch] + llHdl->usPerTick;
+    u_int32 dist = delta < 0 ? (u_int32)-delta : (u_int32)delta;
+
+    /* dt > 1000 s can't limit a 32-bit difference */
+    if (dt < 1000000000 &&
+        (int64)dist * 1000000 >
+        (int64)llHdl->glitchLimit[ch] * (int64)dt &&
+        llHdl->glitchRun[ch] < GLITCH_RUN_MAX)
+    {
+        llHdl->glitchRun[ch]++;
+        llHdl->glitchCount[ch]++;
+        return( TRUE );
+    }
+
+    llHdl->glitchRun[ch]   = 0;
+    llHdl->glitchStamp[ch] = now;
+    return( FALSE );
+}
+
+/****************************  M47_UnwrapReset  *****************************
+ *
+ *  Description:  Restart unwrapping of a channel at the next data word.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                ch        channel
+ *
+ *  Output.....:  -
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_UnwrapReset( LL_HANDLE *llHdl, int32 ch ) /* nodoc */
+{
+    OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+    llHdl->posValid[ch] = FALSE;
+    llHdl->histCnt[ch]  = 0;
+    llHdl->vel[ch]      = 0;
+    llHdl->acc[ch]      = 0;
+    OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+}
+
+/******************************  M47_Motion  ********************************
+ *
+ *  Description:  Update velocity and acceleration of a channel.
+ *
+ *                The current position starts a new entry of the
+ *                channel's motion history if at least one frame time
+ *                (M47_FrameTimeUs) passed since the newest entry.
+ *                Otherwise it replaces the position of the newest entry,
+ *                so no update is dropped. Velocity and acceleration are
+ *                recomputed on every call:
+ *
+ *                    vel = (pos[0] - pos[-N]) / (t[0] - t[-N])
+ *                    acc = (vel[0] - vel[-N]) / (t[0] - t[-N])
+ *
+ *                N is the filter window (M47_MOTION_WINDOW) or the number
+ *                of older entries, if less. The times come from
+ *                M47_TimeUs (system tick resolution), so the window
+ *                should span several ticks. Values are fixed point with
+ *                M47_MOTION_FRAC fractional bits, computed by M47_MulDiv
+ *                without intermediate overflow.
+ *                The caller must hold the spin lock.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                ch        channel
+ *
+ *  Output.....:  -
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_Motion( LL_HANDLE *llHdl, int32 ch ) /* nodoc */
+{
+    M47_HIST_ENT *hist = llHdl->hist[ch];
+    M47_HIST_ENT *ent, *old;
+    u_int64      now = M47_TimeUs( llHdl );
+    u_int32      n, dt;
+
+    ent = &hist[llHdl->histIdx[ch]];
+
+    if (llHdl->histCnt[ch] &&
+        now - ent->stamp < M47_FrameTimeUs( llHdl, ch )) {
+        /* no frame time since the newest entry: update it */
+        ent->pos = llHdl->pos[ch];
+    }
+    else {
+        if (llHdl->histCnt[ch])
+            llHdl->histIdx[ch] = (llHdl->histIdx[ch] + 1) % MOTION_HIST;
+        else
+            llHdl->histIdx[ch] = 0;
+
+        if (llHdl->histCnt[ch] < MOTION_HIST)
+            llHdl->histCnt[ch]++;
+
+        ent = &hist[llHdl->histIdx[ch]];
+        ent->pos   = llHdl->pos[ch];
+        ent->stamp = now;
+    }
+
+    /* entries to look back */
+    n = llHdl->histCnt[ch] - 1;
+    if (n > llHdl->motionWin)
+        n = llHdl->motionWin;
+
+    if (n == 0) {
+        ent->vel = llHdl->vel[ch] = llHdl->acc[ch] = 0;
+        return;
+    }
+
+    old = &hist[(llHdl->histIdx[ch] + MOTION_HIST - n) % MOTION_HIST];
+
+    /* no motion estimate over more than 2^32 us */
+    if ((ent->stamp - old->stamp) >> 32) {
+        ent->vel = llHdl->vel[ch] = llHdl->acc[ch] = 0;
+        return;
+    }
+    dt = (u_int32)(ent->stamp - old->stamp);
+
+    ent->vel = M47_MulDiv( ent->pos - old->pos,
+                           (u_int32)1000000 << M47_MOTION_FRAC, dt );
+    llHdl->vel[ch] = ent->vel;
+    llHdl->acc[ch] = M47_MulDiv( ent->vel - old->vel, 1000000, dt );
+}
+
+/******************************  M47_Div64  *********************************
+ *
+ *  Description:  Signed 64-bit by 32-bit division.
+ *
+ *                Avoids the compiler's 64-bit division helpers, which are
+ *                not available in all kernels.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  num       dividend
+ *                den       divisor (!= 0)
+ *
+ *  Output.....:  return    quotient (rounded towards zero)
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static int64 M47_Div64( int64 num, u_int32 den ) /* nodoc */
+{
+    u_int64 n = (num < 0) ? -(u_int64)num : (u_int64)num;
+    u_int64 q = 0, r = 0;
+    int32   i;
+
+    if (!(n >> 32))
+        q = (u_int32)n / den;
+    else {
+        /* shift-subtract */
+        for (i = 63; i >= 0; i--) {
+            r = (r << 1) | ((n >> i) & 1);
+            if (r >= den) {
+                r -= den;
+                q |= (u_int64)1 << i;
+            }
+        }
+    }
+
+    return( (num < 0) ? -(int64)q : (int64)q );
+}
+
+/******************************  M47_MulDiv  ********************************
+ *
+ *  Description:  Signed num * mul / den without 64-bit overflow.
+ *
+ *                num is divided first (num = q * den + r), then q * mul
+ *                and r * mul / den are added. With mul < 2^31, neither
+ *                product overflows. Results of 2^32 * mul and more are
+ *                saturated.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  num       dividend
+ *                mul       factor (< 2^31)
+ *                den       divisor (!= 0)
+ *
+ *  Output.....:  return    result (rounded towards zero)
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static int64 M47_MulDiv( int64 num, u_int32 mul, u_int32 den ) /* nodoc */
+{
+    int64 q = M47_Div64( num, den );
+    int64 r = num - q * (int64)den;     /* |r| < den */
+
+    if (q >= ((int64)1 << 32) || q <= -((int64)1 << 32))
+        return( (q < 0) ? -INT64_SAT : INT64_SAT );
+
+    return( q * (int64)mul + M47_Div64( r * (int64)mul, den ) );
+}
+
+/******************************  M47_Sat32  *********************************
+ *
+ *  Description:  Saturate a 64-bit value to 32 bit.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  val       value
+ *
+ *  Output.....:  return    saturated value
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static int32 M47_Sat32( int64 val ) /* nodoc */
+{
+    if (val > 0x7fffffff)
+        return( 0x7fffffff );
+    if (val < -0x7fffffff - 1)
+        return( -0x7fffffff - 1 );
+    return( (int32)val );
+}
+
+/****************************  M47_SampleStart  *****************************
+ *
+ *  Description:  Start, restart or stop background sampling.
+ *
+ *                The sampling alarm is created on first use and
+ *                programmed cyclically with the given period.
+ *                A period of 0 stops sampling. Buffered samples are
+ *                kept.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                period    sampling period [ms] (0=stop)
+ *
+ *  Output.....:  return    success (0) or error code
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static int32 M47_SampleStart( LL_HANDLE *llHdl, u_int32 period ) /* nodoc */
+{
+    int32 error;
+
+    /* stop running alarm */
+    if (llHdl->samplePeriod) {
+        OSS_AlarmClear(llHdl->osHdl, llHdl->alarmHdl);
+        llHdl->samplePeriod = 0;
+    }
+
+    if (period == 0)
+        return(ERR_SUCCESS);
+
+    if (!llHdl->sampleDepth)
+        return(ERR_LL_ILL_FUNC);
+
+    if (!llHdl->alarmHdl &&
+        (error = OSS_AlarmCreate(llHdl->osHdl, M47_SampleAlarm, llHdl,
+                                 &llHdl->alarmHdl)))
+        return(error);
+
+    if ((error = OSS_AlarmSet(llHdl->osHdl, llHdl->alarmHdl, period, 1,
+                              &llHdl->samplePeriod))) {
+        llHdl->samplePeriod = 0;
+        return(error);
+    }
+
+    DBGWRT_2((DBH, "LL - M47_SampleStart: period=%d ms\n",
+              llHdl->samplePeriod));
+
+    return(ERR_SUCCESS);
+}
+
+/****************************  M47_ConnectStart  ****************************
+ *
+ *  Description:  Start, restart or stop connection monitoring.
+ *
+ *                The monitor alarm collects the transfer bits of the
+ *                Status Register every period, so M47_CHECK_CONNECT
+ *                doesn't need to wait. The period should exceed two
+ *                transmission cycles of the slowest channel.
+ *                A period of 0 stops monitoring.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                period    monitor period [ms] (0=stop)
+ *
+ *  Output.....:  return    success (0) or error code
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static int32 M47_ConnectStart( LL_HANDLE *llHdl, u_int32 period ) /* nodoc */
+{
+    int32 error;
+
+    /* stop running alarm */
+    if (llHdl->connPeriod) {
+        OSS_AlarmClear(llHdl->osHdl, llHdl->connAlarmHdl);
+        llHdl->connPeriod = 0;
+    }
+
+    if (period == 0)
+        return(ERR_SUCCESS);
+
+    if (!llHdl->connAlarmHdl &&
+        (error = OSS_AlarmCreate(llHdl->osHdl, M47_ConnectAlarm, llHdl,
+                                 &llHdl->connAlarmHdl)))
+        return(error);
+
+    /* start a new measurement interval */
+    if (llHdl->ready)
+        M47_WR16(llHdl, STATUS_REG, 0x0000);
+
+    OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+    llHdl->connSeen  = 0;
+    llHdl->connValid = FALSE;
+    OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+
+    if ((error = OSS_AlarmSet(llHdl->osHdl, llHdl->connAlarmHdl, period, 1,
+                              &llHdl->connPeriod))) {
+        llHdl->connPeriod = 0;
+        return(error);
+    }
+
+    DBGWRT_2((DBH, "LL - M47_ConnectStart: period=%d ms\n",
+              llHdl->connPeriod));
+
+    return(ERR_SUCCESS);
+}
+
+/****************************  M47_ConnectAlarm  ****************************
+ *
+ *  Description:  Alarm routine for connection monitoring.
+ *
+ *                Takes the transfer bits collected since the last call
+ *                as new connection state and clears them.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  arg       low-level handle
+ *
+ *  Output.....:  -
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_ConnectAlarm( void *arg ) /* nodoc */
+{
+    LL_HANDLE *llHdl = (LL_HANDLE*)arg;
+    u_int16   status;
+
+    if (!llHdl->ready)
+        return;
+
+    status = MREAD_D16(llHdl->ma, STATUS_REG);
+    MWRITE_D16(llHdl->ma, STATUS_REG, 0x0000);
+
+    OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+    llHdl->connMask  = (status | llHdl->connSeen) & STATUS_TRANSFER;
+    llHdl->connSeen  = 0;
+    llHdl->freshSeen |= status & STATUS_TRANSFER;
+    M47_FrameSeen( llHdl, status );
+    llHdl->connStamp = M47_TimeUs( llHdl );
+    llHdl->connValid = TRUE;
+    OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+}
+
+/****************************  M47_ConnectProbe  ****************************
+ *
+ *  Description:  Probe the sensor connection.
+ *
+ *                Clears the transfer bits and polls them, sleeping the
+ *                shortest frame time of the enabled channels (at least
+ *                1 ms) in between. The device semaphore is released
+ *                while sleeping, like in M47_WaitValid. Returns as soon
+ *                as all enabled channels transferred, at the latest after
+ *                CONNECT_PROBE_MS, and at once if no channel is enabled.
+ *                Updates the cached state.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *
+ *  Output.....:  return    transfer bits TA..TD
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static u_int32 M47_ConnectProbe( LL_HANDLE *llHdl ) /* nodoc */
+{
+    u_int32 want = 0, step = CONNECT_PROBE_MS, waited = 0, bits = 0, t;
+    int32   ch, slept;
+    u_int16 status;
+
+    for (ch = 0; ch < CH_NUMBER; ch++) {
+        if (!llHdl->options[ch].dataWidth)
+            continue;
+        want |= 1 << ch;
+        t = (M47_FrameTimeUs( llHdl, ch ) + 999) / 1000;
+        if (t < step)
+            step = t;
+    }
+
+    if (step == 0)
+        step = 1;
+
+    /* all channels stopped: nothing to wait for */
+    if (want) {
+        OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+        llHdl->connSeen = 0;
+        OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+
+        MWRITE_D16(llHdl->ma, STATUS_REG, 0x0000);
+
+        do {
+            /* release device while sleeping */
+            OSS_SemSignal( llHdl->osHdl, llHdl->devSemHdl );
+            slept = OSS_Delay( llHdl->osHdl, step );
+            OSS_SemWait( llHdl->osHdl, llHdl->devSemHdl,
+                         OSS_SEM_WAITFOREVER );
+
+            waited += slept > 0 ? slept : step;
+
+            status = MREAD_D16(llHdl->ma, STATUS_REG);
+            OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+            bits = (status | llHdl->connSeen) & STATUS_TRANSFER;
+            OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+        } while ((bits & want) != want && waited < CONNECT_PROBE_MS);
+
+        /* taken, don't count them again */
+        MWRITE_D16(llHdl->ma, STATUS_REG, 0x0000);
+    }
+
+    OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+    llHdl->connMask  = bits;
+    llHdl->freshSeen |= bits;
+    M47_FrameSeen( llHdl, bits );
+    llHdl->connStamp = M47_TimeUs( llHdl );
+    llHdl->connValid = TRUE;
+    OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+
+    return( bits );
+}
+
+/****************************  M47_ValidReset  ******************************
+ *
+ *  Description:  Start a new configuration generation of channels.
+ *
+ *                Acknowledges the transfer bits (keeping them for the
+ *                connection monitor), so a transfer bit set afterwards
+ *                marks a frame taken with the new configuration.
+ *                Must be called after the new configuration is written.
+ *                For channels that kept running, the frame in flight may
+ *                have been taken with the old configuration, so their
+ *                next transfer bit is discarded (see M47_FrameSeen).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                chMask    channels whose configuration changed
+ *                running   channels of chMask that kept running
+ *
+ *  Output.....:  -
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_ValidReset(
+    LL_HANDLE *llHdl,
+    u_int32 chMask,
+    u_int32 running
+) /* nodoc */
+{
+    u_int16 status;
+    u_int64 now;
+    int32   ch;
+
+    status = M47_RD16(llHdl, STATUS_REG);
+    M47_WR16(llHdl, STATUS_REG, 0x0000);
+
+    OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+    llHdl->connSeen  |= status & STATUS_TRANSFER;
+    llHdl->frameSeen  = (llHdl->frameSeen | status) & STATUS_TRANSFER & ~chMask;
+    llHdl->freshSeen  = (llHdl->freshSeen | status) & STATUS_TRANSFER & ~chMask;
+    llHdl->vecSeen    = (llHdl->vecSeen | status) & STATUS_TRANSFER & ~chMask;
+    llHdl->validMask &= ~chMask;
+    llHdl->skipMask   = (llHdl->skipMask & ~chMask) | running;
+    now = M47_TimeUs( llHdl );
+    for (ch = 0; ch < CH_NUMBER; ch++) {
+        if (chMask & (1 << ch)) {
+            llHdl->cfgGen[ch]++;
+            llHdl->frameStamp[ch] = now;    /* no timeout yet */
+        }
+    }
+    OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+}
+
+/****************************  M47_FrameSeen  *******************************
+ *
+ *  Description:  Record acknowledged transfer bits for the data valid logic.
+ *
+ *                The first transfer bit of a channel in skipMask is
+ *                discarded: its frame may have been started with the old
+ *                mode (see M47_Reconfig). The others are also collected
+ *                for M47_VectorRead.
+ *
+ *                Must be called with the spin lock held.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                bits      transfer bits TA..TD
+ *
+ *  Output.....:  -
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_FrameSeen( LL_HANDLE *llHdl, u_int32 bits ) /* nodoc */
+{
+    u_int32 skip;
+
+    bits &= STATUS_TRANSFER;
+    skip  = bits & llHdl->skipMask;
+
+    llHdl->skipMask  &= ~skip;
+    llHdl->frameSeen |= bits & ~skip;
+    llHdl->vecSeen   |= bits & ~skip;
+}
+
+/****************************  M47_WaitValid  *******************************
+ *
+ *  Description:  Wait until a channel delivered a frame with its current
+ *                configuration.
+ *
+ *                Polls the transfer bit and sleeps a frame time (at
+ *                least 1 ms) between the polls. The device semaphore is
+ *                released while sleeping, like in M47_FifoRead.
+ *
+ *                If the channel is reconfigured meanwhile, the wait goes
+ *                on for the new configuration generation (same timeout).
+ *                If a bitstream is loaded meanwhile (M47_BLK_FLEXLOAD),
+ *                all channels were reprogrammed and ERR_LL_DEV_NOTRDY is
+ *                returned.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                ch        channel
+ *
+ *  Output.....:  genP      configuration generation
+ *                return    success (0) or error code
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static int32 M47_WaitValid( LL_HANDLE *llHdl, int32 ch, u_int32 *genP ) /* nodoc */
+{
+    u_int32 bit    = 1 << ch;
+    u_int32 waited = 0;     /* [ms] */
+    u_int32 loads  = llHdl->flexLoads;
+    u_int32 valid, stepMs;
+    int32   slept;
+    u_int16 status;
+
+    for (;;) {
+        status = MREAD_D16(llHdl->ma, STATUS_REG);
+        MWRITE_D16(llHdl->ma, STATUS_REG, 0x0000);
+
+        OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+        llHdl->connSeen  |= status & STATUS_TRANSFER;
+        llHdl->freshSeen |= status & STATUS_TRANSFER;
+        M47_FrameSeen( llHdl, status );
+        if (llHdl->frameSeen & bit)
+            llHdl->validMask |= bit;
+        valid = llHdl->validMask & bit;
+        *genP = llHdl->cfgGen[ch];
+        OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+
+        if (valid)
+            return(ERR_SUCCESS);
+
+        if (waited >= llHdl->validTimeout)
+            break;
+
+        stepMs = (M47_FrameTimeUs( llHdl, ch ) + 999) / 1000;
+        if (stepMs == 0)
+            stepMs = 1;
+
+        /* release device while sleeping */
+        OSS_SemSignal( llHdl->osHdl, llHdl->devSemHdl );
+        slept = OSS_Delay( llHdl->osHdl, stepMs );
+        OSS_SemWait( llHdl->osHdl, llHdl->devSemHdl, OSS_SEM_WAITFOREVER );
+
+        waited += slept > 0 ? slept : stepMs;
+
+        /* PLD reloaded meanwhile: registers reprogrammed from scratch */
+        if (llHdl->flexLoads != loads)
+            return(ERR_LL_DEV_NOTRDY);
+
+        /* reconfigured meanwhile: wait for the new generation */
+        if (llHdl->cfgGen[ch] != *genP) {
+            DBGWRT_2((DBH, "LL - M47_WaitValid: ch%d gen %d -> %d\n",
+                      ch, *genP, llHdl->cfgGen[ch]));
+        }
+    }
+
+    DBGWRT_ERR((DBH, " *** M47_WaitValid: ch%d no frame since gen %d\n",
+                ch, *genP));
+    return(ERR_OSS_TIMEOUT);
+}
+
+/****************************  M47_ApplyConfig  *****************************
+ *
+ *  Description:  Validate and apply the configuration of all channels.
+ *
+ *                Nothing is written to the hardware if a parameter is
+ *                invalid. Otherwise all changes are applied with a single
+ *                M47_Reconfig() call, so each changed channel is stopped
+ *                and restarted only once.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                cfg       new configuration
+ *
+ *  Output.....:  return    success (0) or error code
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static int32 M47_ApplyConfig( LL_HANDLE *llHdl, M47_CONFIG *cfg ) /* nodoc */
+{
+    int32 ch;
+
+    /*------------------------------+
+    |  validate                     |
+    +------------------------------*/
+    for (ch = 0; ch < CH_NUMBER; ch++) {
+        if (cfg->ch[ch].baudRate  > 3  ||
+            cfg->ch[ch].dataWidth > 32 ||
+            cfg->ch[ch].transMode > 1)
+            return(ERR_LL_ILL_PARAM);
+
+        /* HW revision < 2: global baud rate and data width */
+        if (llHdl->moduleHwRev < HW_MAJOR_REV_2 &&
+            (cfg->ch[ch].baudRate  != cfg->ch[0].baudRate ||
+             cfg->ch[ch].dataWidth != cfg->ch[0].dataWidth))
+            return(ERR_LL_ILL_FUNC);
+    }
+
+    /*------------------------------+
+    |  apply                        |
+    +------------------------------*/
+    for (ch = 0; ch < CH_NUMBER; ch++) {
+        if (llHdl->options[ch].transMode != cfg->ch[ch].transMode)
+            M47_UnwrapReset( llHdl, ch );
+
+        llHdl->options[ch].baudRate  = (u_int16)cfg->ch[ch].baudRate;
+        llHdl->options[ch].dataWidth = (u_int16)cfg->ch[ch].dataWidth;
+        llHdl->options[ch].transMode = (u_int16)cfg->ch[ch].transMode;
+    }
+
+    M47_Reconfig( llHdl );
+
+    DBGWRT_2((DBH, "LL - M47_ApplyConfig: done\n"));
+
+    return(ERR_SUCCESS);
+}
+
+/****************************  M47_SampleAlarm  *****************************
+ *
+ *  Description:  Alarm routine for background sampling.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  arg       low-level handle
+ *
+ *  Output.....:  -
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_SampleAlarm( void *arg ) /* nodoc */
+{
+    LL_HANDLE *llHdl = (LL_HANDLE*)arg;
+
+    if (llHdl->ready)
+        M47_Acquire( llHdl );
+}
+
+/******************************  M47_Acquire  *******************************
+ *
+ *  Description:  Sample all enabled channels into their ring buffers.
+ *
+ *                Channels with a data width of 0 (transmission stopped)
+ *                are skipped. When a ring buffer is full, the oldest
+ *                sample is overwritten and the overrun counter is
+ *                incremented. Readers waiting for a sample are woken up.
+ *
+ *                Called from the sampling alarm and the simulated
+ *                interrupt.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *
+ *  Output.....:  -
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_Acquire( LL_HANDLE *llHdl ) /* nodoc */
+{
+    u_int32  data[CH_NUMBER];
+    M47_RING *ring;
+    int32    ch;
+    u_int32  wake;
+    u_int64  stamp;
+
+    /* read hardware outside of the lock, track the positions */
+    for (ch = 0; ch < CH_NUMBER; ch++) {
+        if (llHdl->options[ch].dataWidth) {
+            data[ch] = M47_ReadData( llHdl, ch );
+            M47_Unwrap( llHdl, ch, data[ch] );
+        }
+    }
+
+    OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+
+    stamp = M47_TimeUs( llHdl );
+
+    for (ch = 0; ch < CH_NUMBER; ch++) {
+        if (!llHdl->options[ch].dataWidth)
+            continue;
+
+        ring = &llHdl->ring[ch];
+
+        ring->buf[ring->wrIdx].stamp = stamp;
+        ring->buf[ring->wrIdx].age   = M47_FrameTimeUs( llHdl, ch ) * 3 / 2;
+        ring->buf[ring->wrIdx].seq   = ring->seq++;
+        ring->buf[ring->wrIdx].value = data[ch];
+
+        if (++ring->wrIdx == llHdl->sampleDepth)
+            ring->wrIdx = 0;
+
+        if (ring->count == llHdl->sampleDepth) {
+            /* full: drop oldest sample */
+            ring->rdIdx = ring->wrIdx;
+            ring->overrun++;
+        }
+        else
+            ring->count++;
+    }
+
+    wake = llHdl->readWait;
+    llHdl->readWait = 0;
+
+    OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+
+    /* wake up the readers of each channel */
+    for (ch = 0; ch < CH_NUMBER; ch++)
+        if (wake & (1 << ch))
+            OSS_SemSignal( llHdl->osHdl, llHdl->readSemHdl[ch] );
+}
+
+/*****************************  M47_IrqEnable  *****************************
+ *
+ *  Description:  Enable/disable the simulated frame-complete interrupt.
+ *
+ *                The M47 interrupt enable is not documented, so without
+ *                IRQ_SIM_PERIOD there is no interrupt source: enabling
+ *                fails with ERR_LL_ILL_FUNC, the hardware stays on the
+ *                polled path (SAMPLE_PERIOD).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                enable    TRUE=enable, FALSE=disable
+ *
+ *  Output.....:  return    success (0) or error code
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static int32 M47_IrqEnable( LL_HANDLE *llHdl, u_int32 enable ) /* nodoc */
+{
+    int32   error;
+    u_int32 realMsec;
+
+    DBGWRT_2((DBH, "LL - M47_IrqEnable: enable=%d sim=%d\n",
+              enable, llHdl->irqSimPeriod));
+
+    /* no hardware interrupt */
+    if (!llHdl->irqSimPeriod)
+        return(enable ? ERR_LL_ILL_FUNC : ERR_SUCCESS);
+
+    if (!enable) {
+        if (llHdl->irqSimAlarmHdl)
+            OSS_AlarmClear(llHdl->osHdl, llHdl->irqSimAlarmHdl);
+
+        llHdl->irqEnabled = FALSE;
+        return(ERR_SUCCESS);
+    }
+
+    /* captured frames go to the ring buffers */
+    if (!llHdl->sampleDepth)
+        return(ERR_LL_ILL_FUNC);
+
+    llHdl->irqEnabled = TRUE;
+
+    if (!llHdl->irqSimAlarmHdl &&
+        (error = OSS_AlarmCreate(llHdl->osHdl, M47_IrqSimAlarm, llHdl,
+                                 &llHdl->irqSimAlarmHdl)))
+        goto ERR_EXIT;
+
+    if ((error = OSS_AlarmSet(llHdl->osHdl, llHdl->irqSimAlarmHdl,
+                              llHdl->irqSimPeriod, 1, &realMsec)))
+        goto ERR_EXIT;
+
+    return(ERR_SUCCESS);
+
+ERR_EXIT:
+    llHdl->irqEnabled = FALSE;
+    return(error);
+}
+
+/****************************  M47_IrqSimAlarm  *****************************
+ *
+ *  Description:  Alarm routine of the simulated interrupt source.
+ *
+ *                Counts the frame-complete interrupt (M_LL_IRQ_COUNT),
+ *                captures all enabled channels into the ring buffers and
+ *                wakes up waiting readers.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  arg       low-level handle
+ *
+ *  Output.....:  -
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_IrqSimAlarm( void *arg ) /* nodoc */
+{
+    LL_HANDLE *llHdl = (LL_HANDLE*)arg;
+
+    if (!llHdl->irqEnabled || !llHdl->ready)
+        return;
+
+    IDBGWRT_1((DBH, ">>> M47_IrqSimAlarm:\n"));
+
+    llHdl->irqCount++;
+
+    M47_Acquire( llHdl );
+}
+
+/*****************************  M47_FifoRead  *******************************
+ *
+ *  Description:  Drain the ring buffer of a channel (M47_BLKRD_FIFO and
+ *                M47_BLKRD_FIFO_TS mode).
+ *
+ *                If the ring buffer is empty, the function waits up to
+ *                M47_READ_TIMEOUT ms for the next sample. The device
+ *                semaphore is released while waiting.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl        low-level handle
+ *                ch           current channel
+ *                buf          data buffer
+ *                size         data buffer size
+ *  Output.....:  nbrRdBytesP  number of read bytes
+ *                return       success (0) or error code
+ *  Globals....:  -
+ ****************************************************************************/
+static int32 M47_FifoRead( /* nodoc */
+     LL_HANDLE *llHdl,
+     int32     ch,
+     void      *buf,
+     int32     size,
+     int32     *nbrRdBytesP
+)
+{
+    M47_RING     *ring  = &llHdl->ring[ch];
+    M47_SAMPLE   *smpP  = (M47_SAMPLE*)buf;
+    M47_TSAMPLE  *tsmpP = (M47_TSAMPLE*)buf;
+    M47_RING_ENT *ent;
+    u_int32      recSize, n, i;
+
+    recSize = (llHdl->blkRdMode == M47_BLKRD_FIFO) ?
+              sizeof(M47_SAMPLE) : sizeof(M47_TSAMPLE);
+    n = size / recSize;
+
+    if (n == 0)
+    {
+        *nbrRdBytesP = 0;
+        return (ERR_LL_USERBUF);
+    }
+
+    if (llHdl->readTimeout)
+    {
+        int32 error, empty;
+
+        /* discard stale wake-up */
+        OSS_SemWait( llHdl->osHdl, llHdl->readSemHdl[ch], 0 );
+
+        OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+        empty = (ring->count == 0);
+        if (empty)
+            llHdl->readWait |= 1 << ch;
+        OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+
+        if (empty)
+        {
+            /* release device while waiting */
+            OSS_SemSignal( llHdl->osHdl, llHdl->devSemHdl );
+            error = OSS_SemWait( llHdl->osHdl, llHdl->readSemHdl[ch],
+                                 llHdl->readTimeout );
+            OSS_SemWait( llHdl->osHdl, llHdl->devSemHdl,
+                         OSS_SEM_WAITFOREVER );
+
+            OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+            llHdl->readWait &= ~(1 << ch);
+            empty = (ring->count == 0);
+            OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+
+            if (empty)
+            {
+                *nbrRdBytesP = 0;
+                return (error ? error : ERR_OSS_TIMEOUT);
+            }
+        }
+    }
+
+    OSS_SpinLockAcquire( llHdl->osHdl, llHdl->lockHdl );
+
+    if (n > ring->count)
+        n = ring->count;
+
+    for (i = 0; i < n; i++)
+    {
+        ent = &ring->buf[ring->rdIdx];
+
+        if (llHdl->blkRdMode == M47_BLKRD_FIFO) {
+            smpP->seq   = ent->seq;
+            smpP->value = ent->value;
+            smpP++;
+        }
+        else {
+            tsmpP->seq   = ent->seq;
+            tsmpP->value = ent->value;
+            tsmpP->stamp = ent->stamp;
+            tsmpP->latch = ent->stamp - ent->age;
+            tsmpP++;
+        }
+
+        if (++ring->rdIdx == llHdl->sampleDepth)
+            ring->rdIdx = 0;
+    }
+    ring->count -= n;
+
+    OSS_SpinLockRelease( llHdl->osHdl, llHdl->lockHdl );
+
+#ifndef M47_FAST
+    DBGWRT_2((DBH, "LL - M47_FifoRead: %d samples\n", n));
+#endif
+
+    *nbrRdBytesP = n * recSize;
+    return(ERR_SUCCESS);
+}
+
+/******************************  M47_TimeUs  ********************************
+ *
+ *  Description:  Get monotonic driver time.
+ *
+ *                The time is derived from the OSS system tick, extended
+ *                to 64 bit. Its resolution is one system tick.
+ *                The caller must hold the spin lock.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *
+ *  Output.....:  return    time [us]
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static u_int64 M47_TimeUs( LL_HANDLE *llHdl ) /* nodoc */
+{
+    u_int32 tick = OSS_TickGet( llHdl->osHdl );
+
+    if (tick < llHdl->tickLast)
+        llHdl->tickHigh++;          /* tick counter wrapped */
+    llHdl->tickLast = tick;
+
+    return( (((u_int64)llHdl->tickHigh << 32) | tick) * llHdl->usPerTick );
+}
+
+/****************************  M47_FrameTimeUs  *****************************
+ *
+ *  Description:  Get the SSI frame time of a channel.
+ *
+ *                The frame consists of dataWidth+1 clock periods
+ *                plus the sensor's monoflop time.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl     low-level handle
+ *                ch        channel
+ *
+ *  Output.....:  return    frame time [us]
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static u_int32 M47_FrameTimeUs( LL_HANDLE *llHdl, int32 ch ) /* nodoc */
+{
+    /* clock period: 2us at 500 kbaud, doubled for each baudrate step */
+    return( (llHdl->options[ch].dataWidth + 1) *
+            (2 << llHdl->options[ch].baudRate) + SSI_TMONO_US );
+}
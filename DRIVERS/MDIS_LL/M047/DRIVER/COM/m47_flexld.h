@@ -0,0 +1,207 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: m47_flexld.h
+ *
+ *       Author: ag
+ *
+ *  Description: JTAG loaders for the FLEXlogic bitstream
+ *
+ *               Shared by the M47 driver and the m47_flexsim tool, which
+ *               checks them against the original loader. The includer must
+ *               provide MACCESS, MWRITE_D16 and FLEXREG and include
+ *               m47_flexz.h before this file.
+ *
+ *               FLEXREG bits: 0 = TDO, 1 = TCK, 2 = TMS
+ *
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+ /*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _M47_FLEXLD_H
+#define _M47_FLEXLD_H
+
+#define FLEX_TDO    0x0001      /* FLEXREG: JTAG TDO (PLD data in) */
+#define FLEX_TCK    0x0002      /* FLEXREG: JTAG TCK */
+#define FLEX_TMS    0x0004      /* FLEXREG: JTAG TMS */
+
+/* progress of M47_FlexLoadZ() */
+typedef struct {
+    const u_int8  *tdo;             /* next TDO byte */
+    const u_int16 *tms;             /* next TMS run */
+    u_int32 run;                    /* cycles left at current TMS */
+    u_int32 bits;                   /* TDO bits of current byte */
+    u_int32 n;                      /* cycles done */
+    u_int16 tmsBit;                 /* current TMS */
+    u_int16 prev;                   /* last control word */
+} M47_FLEXZ_STATE;
+
+/************************** M47_FlexLoadZStart ******************************
+ *
+ *  Description:  Prepare loading the compressed bitstream.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  st       load state
+ *
+ *  Output.....:  -
+ *
+ *  Globals....:  M47_FlexzTdo, M47_FlexzTms
+ ****************************************************************************/
+static void M47_FlexLoadZStart( M47_FLEXZ_STATE *st )
+{
+    st->tdo    = M47_FlexzTdo;
+    st->tms    = M47_FlexzTms;
+    st->run    = *st->tms++;
+    st->bits   = 0;
+    st->n      = 0;
+    st->tmsBit = 0;
+    st->prev   = 0;
+}
+
+/**************************** M47_FlexLoadZ *********************************
+ *
+ *  Description:  Shift the compressed bitstream into the PLD.
+ *
+ *                Per JTAG cycle three FLEXREG writes are done: TCK low
+ *                with the previous TDO/TMS, new TDO/TMS, TCK high.
+ *                TDO comes from a bit plane (8 cycles per byte), TMS
+ *                from a table of alternating run lengths starting with
+ *                TMS=0, so the control word is a single OR per cycle.
+ *
+ *                The load can be split into several calls; TCK stays
+ *                high in between.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  ma       access handle
+ *                st       load state (see M47_FlexLoadZStart)
+ *                cycles   max. number of JTAG cycles to do
+ *
+ *  Output.....:  return   TRUE if the bitstream is complete
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static int32 M47_FlexLoadZ( MACCESS ma, M47_FLEXZ_STATE *st, u_int32 cycles )
+{
+    /* work on locals, the state is saved once per call */
+    const u_int8  *tdo = st->tdo;
+    const u_int16 *tms = st->tms;
+    u_int32 run    = st->run;
+    u_int32 bits   = st->bits;
+    u_int32 n      = st->n;
+    u_int32 end    = n + cycles;
+    u_int16 tmsBit = st->tmsBit;
+    u_int16 prev   = st->prev;
+    u_int16 ctrl;
+
+    if (end > M47_FLEXZ_CYCLES || end < n)
+        end = M47_FLEXZ_CYCLES;
+
+    for (; n < end; n++) {
+        while (!run) {
+            run = *tms++;
+            tmsBit ^= FLEX_TMS;
+        }
+        run--;
+
+        if (!(n & 7))
+            bits = *tdo++;
+
+        ctrl = (u_int16)((bits & FLEX_TDO) | tmsBit);
+        bits >>= 1;
+
+        MWRITE_D16( ma, FLEXREG, prev );
+        MWRITE_D16( ma, FLEXREG, ctrl );
+        MWRITE_D16( ma, FLEXREG, ctrl | FLEX_TCK );
+        prev = ctrl;
+    }
+
+    st->tdo    = tdo;
+    st->tms    = tms;
+    st->run    = run;
+    st->bits   = bits;
+    st->n      = n;
+    st->tmsBit = tmsBit;
+    st->prev   = prev;
+
+    return( n == M47_FLEXZ_CYCLES );
+}
+
+/**************************** M47_FlexLoadRaw *******************************
+ *
+ *  Description:  Shift an uncompressed bitstream into the PLD.
+ *
+ *                Same waveform as M47_FlexLoadZ(). Each data byte holds
+ *                four JTAG cycles, LSB first: bit 0 = TDO, bit 1 = TMS.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  ma       access handle
+ *                data     bitstream data (without size header)
+ *                size     number of data bytes
+ *
+ *  Output.....:  -
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static void M47_FlexLoadRaw( MACCESS ma, const u_int8 *data, u_int32 size )
+{
+    static const u_int16 symCtrl[4] =
+        { 0, FLEX_TDO, FLEX_TMS, FLEX_TMS | FLEX_TDO };
+    u_int16 prev = 0;
+    u_int16 ctrl;
+    u_int32 sym, n;
+
+    while (size--) {
+        sym = *data++;
+
+        for (n = 0; n < 4; n++, sym >>= 2) {
+            ctrl = symCtrl[sym & 3];
+
+            MWRITE_D16( ma, FLEXREG, prev );
+            MWRITE_D16( ma, FLEXREG, ctrl );
+            MWRITE_D16( ma, FLEXREG, ctrl | FLEX_TCK );
+            prev = ctrl;
+        }
+    }
+}
+
+/****************************** M47_FlexHash *********************************
+ *
+ *  Description:  Compute the FNV-1a hash of a bitstream file.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  data     bitstream file (with size header)
+ *                size     number of bytes
+ *
+ *  Output.....:  return   32 bit hash
+ *
+ *  Globals....:  -
+ ****************************************************************************/
+static u_int32 M47_FlexHash( const u_int8 *data, u_int32 size )
+{
+    u_int32 hash = 0x811c9dc5;
+
+    while (size--) {
+        hash ^= *data++;
+        hash *= 0x01000193;
+    }
+
+    return( hash );
+}
+
+#endif /* _M47_FLEXLD_H */
@@ -0,0 +1,296 @@
+/*
+ *  Code that is loaded into a PLD by the driver (compressed)
+ *
+ *  Copyright 2019, MEN Mikro Elektronik GmbH
+ *
+ *  This binary code is not part of the driver and proprietary.
+ *  Reproduction and distribution is permitted for all customers
+ *  of MEN Mikro Elektronik GmbH.
+ */
+
+static const char M47_FlexIdent[]="M47 - m47 flex data (m47_1r6.bin): $Id: m47_flex.h,v 1.4 2004/08/24 16:10:06 dpfeuffer Exp $";
+
+/* m47_flexz: 32428 JTAG cycles, 4054+458 data bytes */
+#define M47_FLEXZ_CYCLES 32428
+#define M47_FLEXZ_HASH   0x8a9d4347  /* FNV-1a of m47_flex.h data */
+
+/* TDO per cycle, LSB first */
+static const u_int8 M47_FlexzTdo[] = {
+0x00,0x3c,0x00,0xf0,0x3f,0x3c,0x3c,0xdc,0x1f,0x1e,0xe0,0xff,0x7c,0xc0,0xf7,0x43,
+0x9f,0xb0,0x2f,0x02,0x00,0xe6,0x03,0xbe,0x33,0xfa,0x96,0xd7,0x57,0x00,0x70,0x13,
+0x80,0x11,0xdd,0x25,0x8c,0xef,0x00,0x80,0xa5,0x00,0x88,0x84,0x88,0x40,0x64,0x06,
+0x00,0xd8,0x84,0x7f,0xf4,0x7f,0x09,0xbb,0x33,0x00,0x78,0x29,0x80,0x3f,0x22,0x32,
+0x10,0x01,0x01,0x00,0x4b,0x01,0xfc,0x9f,0x99,0xc0,0x88,0x08,0x00,0x10,0x00,0x80,
+0xff,0xe1,0xe1,0xe1,0xfe,0xf0,0x00,0xff,0x33,0x00,0xbe,0x2f,0xf8,0x80,0x7d,0x10,
+0x00,0x80,0x01,0xf0,0x9d,0xd1,0x37,0xbc,0xbc,0x02,0x80,0xf8,0x00,0x8c,0xe8,0x2e,
+0x64,0x7c,0x07,0x00,0xc4,0x07,0x40,0x64,0x64,0x2c,0x33,0x33,0x00,0x30,0x3e,0xfe,
+0xa3,0xff,0x0b,0xd8,0x9d,0x01,0xc0,0xf1,0x01,0xfc,0x11,0x99,0x8b,0x0c,0x08,0x00,
+0x88,0x0f,0xe0,0xff,0xcc,0x54,0x46,0x46,0x00,0x00,0x01,0x00,0xfc,0x0f,0x0f,0x0f,
+0xf7,0x87,0x07,0xf8,0x9f,0x06,0xf0,0xfd,0xd1,0x27,0xec,0x8b,0x00,0x80,0x56,0x80,
+0xef,0x88,0xbe,0xe5,0xf5,0x15,0x00,0xcc,0x07,0x40,0x44,0x77,0x29,0xe3,0x3b,0x00,
+0xa0,0x13,0x00,0x22,0x21,0x22,0x18,0x99,0x01,0x80,0x6f,0x10,0x18,0xfd,0x5f,0xc2,
+0xee,0x0c,0x00,0x9e,0x0f,0xe0,0x8f,0xc8,0x5c,0x64,0x40,0x00,0xc0,0x7c,0x00,0xff,
+0x67,0xa6,0x32,0x32,0x02,0x00,0x0c,0x00,0xe0,0x7f,0x78,0x78,0xb8,0x3f,0x3c,0xc0,
+0xff,0xf8,0x00,0xef,0x8f,0x3e,0x61,0x5f,0x04,0x00,0xc4,0x07,0x78,0x67,0xf4,0x2d,
+0xaf,0x2f,0x00,0x20,0x2f,0x00,0x21,0xba,0x4b,0x19,0xdf,0x01,0x00,0xf1,0x01,0x10,
+0x19,0x19,0xcb,0xcc,0x0c,0x00,0x80,0x8f,0xbf,0xe8,0xff,0x12,0x76,0x67,0x00,0x70,
+0x06,0x00,0x7f,0x04,0x66,0x22,0x03,0x00,0x00,0x32,0x00,0xf8,0x3f,0x33,0x91,0x11,
+0x11,0x00,0x80,0x00,0x00,0xff,0xc3,0xc3,0xc3,0xfd,0xe1,0x01,0xfe,0xcf,0x07,0x78,
+0x7e,0xe4,0x09,0xf2,0x22,0x00,0x60,0x3e,0xc0,0x23,0x23,0x6f,0x79,0x7c,0x04,0x00,
+0xef,0x01,0x10,0xd1,0x5d,0xca,0xf0,0x0e,0x00,0xe0,0x02,0x80,0xc8,0xc8,0x58,0x44,
+0x44,0x00,0xe0,0x2f,0xfc,0x05,0xff,0x97,0xa0,0x3b,0x03,0x80,0x3b,0x01,0xf8,0x23,
+0x22,0x07,0x11,0x10,0x00,0x90,0x19,0xc0,0xff,0x99,0xa1,0x8c,0x84,0x00,0x00,0x05,
+0x00,0xf8,0x1f,0x1e,0x1e,0xee,0x0f,0x0f,0xf0,0xbf,0x23,0x20,0x08,0x82,0x40,0x48,
+0x00,0x01,0x00,0x1c,0x01,0xc1,0x18,0x05,0x0b,0x08,0x28,0x00,0x88,0x0f,0x40,0x88,
+0xee,0x52,0xc6,0x77,0x00,0x40,0x7c,0x00,0x44,0x42,0x44,0x30,0x33,0x03,0x00,0xe3,
+0xa3,0x3f,0xfa,0xbf,0x84,0xdc,0x19,0x00,0x1c,0x1f,0xc0,0x1f,0x91,0xb1,0xc8,0x80,
+0x00,0x80,0xf8,0x00,0xfe,0xcf,0x4c,0x65,0x64,0x04,0x00,0x30,0x00,0xc0,0xff,0xf0,
+0xf0,0x70,0x7f,0x78,0x80,0xff,0xf3,0x01,0xdf,0x1f,0x7d,0xc2,0xbe,0x08,0x00,0x98,
+0x0f,0xf8,0xce,0xe8,0x5b,0x5e,0x5f,0x01,0x40,0x47,0x00,0x46,0x74,0x97,0x32,0xbe,
+0x03,0x00,0xb2,0x02,0x20,0x32,0x32,0x82,0x99,0x19,0x00,0x78,0x17,0x7f,0xc1,0xff,
+0x21,0xec,0x4e,0x00,0xa0,0x1e,0x00,0xfe,0x88,0x8c,0x45,0x06,0x04,0x00,0x74,0x02,
+0xf0,0x7f,0x66,0x0a,0x23,0x23,0x00,0xc0,0x01,0x00,0xfe,0x87,0x87,0x87,0xfb,0xc3,
+0x03,0xfc,0x4f,0x0b,0x88,0xfe,0xe8,0x13,0xf6,0x45,0x00,0x40,0x73,0x40,0x74,0x46,
+0xdf,0xf2,0xfa,0x0a,0x00,0xe2,0x03,0x00,0xa2,0xbb,0x94,0xf1,0x1d,0x00,0x10,0x1f,
+0x00,0x91,0x11,0xb1,0xcc,0xcc,0x00,0xc0,0xf8,0xd8,0x8f,0xfe,0x2f,0x61,0x77,0x06,
+0x00,0xc3,0x07,0xf0,0x47,0x64,0x2e,0x32,0x20,0x00,0x20,0x3e,0x80,0xff,0x33,0x43,
+0x19,0x18,0x01,0x00,0x10,0x90,0xff,0x3f,0x3c,0x3c,0xdc,0x1f,0x1e,0xe0,0xff,0x2d,
+0xc0,0xd3,0x47,0x9d,0xb0,0x2e,0x02,0x00,0x6e,0x01,0x9e,0x33,0xea,0x96,0xd3,0x53,
+0x00,0xf0,0x06,0x80,0x11,0xdd,0xa5,0x0c,0xef,0x00,0x80,0x2c,0x00,0x88,0x8c,0x88,
+0x64,0x66,0x06,0x00,0xec,0xc1,0x5f,0xf0,0x7f,0x08,0xbb,0x32,0x00,0x70,0x3e,0x80,
+0x3f,0x22,0x73,0x91,0x01,0x01,0x00,0x07,0x01,0xfc,0x9f,0x19,0xca,0x48,0x08,0x00,
+0x90,0x00,0xfc,0xff,0xe1,0xe1,0xe1,0xfe,0xf0,0x00,0xff,0xe3,0x03,0xba,0x37,0x7a,
+0x84,0x3d,0x11,0x00,0x10,0x1f,0xd0,0x9d,0xd1,0xb3,0xb8,0xba,0x02,0x80,0xf8,0x00,
+0x0c,0x08,0x00,0x05,0x7c,0x00,0x00,0xc4,0x07,0x40,0x24,0x64,0x0c,0x33,0x33,0x00,
+0x10,0x3e,0xee,0xa3,0xff,0x4b,0xd8,0x8d,0x01,0xc0,0xc9,0x00,0xf8,0x11,0x99,0x8b,
+0x0c,0x08,0x00,0x88,0x0f,0xe0,0xff,0xcc,0x54,0x46,0x46,0x00,0x00,0x05,0xe4,0xff,
+0x0f,0x0f,0x0f,0xf7,0x87,0x07,0xf8,0xff,0x13,0xf0,0xbc,0xd1,0x26,0x6c,0x8b,0x00,
+0x80,0x9f,0x80,0xed,0x8c,0x9e,0xe5,0xb4,0x15,0x00,0xcc,0x07,0x60,0x44,0x77,0x29,
+0x23,0x3b,0x00,0x20,0x3e,0x00,0x22,0x23,0x63,0x99,0x99,0x01,0x80,0xb7,0xf0,0x17,
+0xfc,0x1f,0xc2,0xca,0x0c,0x00,0xec,0x02,0xc0,0x8e,0xc8,0x5c,0x64,0x40,0x00,0xc0,
+0x7c,0x00,0xff,0x67,0xa6,0x32,0x32,0x02,0x00,0x2c,0x00,0xff,0x7f,0x78,0x78,0xb8,
+0x3f,0x3c,0xc0,0xff,0xf8,0x80,0x6d,0x8f,0x1e,0x61,0x4f,0x04,0x00,0xc4,0x07,0x3c,
+0x67,0xb4,0x2d,0xad,0xa7,0x00,0xa0,0x28,0x00,0x23,0xb8,0x4b,0x19,0xc7,0x01,0x00,
+0x7d,0x01,0x00,0x09,0x18,0xcb,0xcc,0x0c,0x00,0x8c,0x8f,0xf7,0xe8,0xff,0x12,0x36,
+0x67,0x00,0x70,0x7c,0x00,0x09,0x44,0xe4,0x20,0x02,0x02,0x00,0xd2,0x02,0xf0,0x3f,
+0x33,0x95,0x91,0x11,0x00,0x80,0x01,0xf8,0xff,0xc3,0xc3,0xc3,0xfd,0xe1,0x01,0xfe,
+0xbf,0x07,0x3c,0x6f,0x74,0x09,0x7b,0x22,0x00,0xe0,0x3d,0xe0,0x39,0xa3,0x6b,0x59,
+0x5d,0x05,0x00,0xf3,0x01,0x18,0xd1,0x5d,0xca,0xa8,0x0e,0x00,0x78,0x03,0x80,0xc8,
+0xc8,0x58,0x66,0x66,0x00,0xe0,0x4f,0xfc,0x05,0xfd,0x87,0x30,0x33,0x03,0x00,0xe7,
+0x03,0xf8,0x23,0x32,0x17,0x19,0x10,0x00,0xd0,0x05,0x80,0xdd,0x11,0xa9,0x88,0x8c,
+0x00,0x00,0x0d,0x60,0xfc,0x1f,0x1e,0x1e,0xee,0x0f,0x0f,0xf0,0x3f,0x3e,0xe0,0xba,
+0xa3,0x47,0xd8,0x15,0x01,0x00,0xf1,0x01,0xd7,0x19,0x3d,0xcb,0xe9,0x29,0x00,0xa8,
+0x03,0xc0,0x08,0xee,0x52,0xc6,0x72,0x00,0x40,0x7c,0x00,0x04,0x46,0xc6,0x32,0x33,
+0x03,0x00,0xe3,0xe3,0x3b,0xda,0xbf,0x84,0xdd,0x19,0x00,0x5c,0x1b,0x40,0x1f,0x91,
+0xb9,0xc8,0x80,0x00,0x80,0xf8,0x00,0x12,0x41,0x44,0x21,0x64,0x04,0x00,0x70,0x00,
+0xfe,0xff,0xf0,0xf0,0x70,0x7f,0x78,0x80,0xff,0xcd,0x01,0xdf,0x1f,0x7d,0xc2,0xbe,
+0x08,0x00,0x68,0x0e,0xf8,0xce,0xe8,0x5b,0x5e,0x5f,0x01,0xc0,0x7c,0x00,0x46,0x74,
+0x97,0x32,0xbe,0x03,0x00,0xd6,0x01,0x20,0x32,0x32,0x96,0x99,0x19,0x00,0xf8,0x1e,
+0x7f,0x81,0xff,0x21,0xcc,0xcc,0x00,0xc0,0xac,0x00,0x9a,0x88,0xcc,0x41,0x06,0x04,
+0x00,0xcc,0x07,0xf0,0x7f,0x66,0x2a,0x23,0x23,0x00,0xc0,0x03,0xc8,0xff,0x87,0x87,
+0x87,0xfb,0xc3,0x03,0xfc,0x8f,0x0f,0x78,0xde,0xe8,0x11,0xf6,0x44,0x00,0x40,0x7c,
+0xc0,0x73,0x46,0xcf,0x72,0x7a,0x0a,0x00,0x3a,0x02,0x30,0x82,0xbb,0x94,0xf1,0x1d,
+0x00,0x10,0x1f,0x00,0x01,0x91,0xb1,0xcc,0xcc,0x00,0xc0,0xf8,0xf8,0x8d,0xfe,0x2f,
+0x61,0x77,0x06,0x00,0xc7,0x07,0xb0,0x43,0x44,0x2e,0x22,0x20,0x00,0xa0,0x29,0x80,
+0xfe,0x33,0x53,0x19,0x19,0x01,0x00,0x20,0xe0,0xfd,0x3f,0x3c,0x3c,0xdc,0x1f,0x1e,
+0xe0,0x7f,0x49,0xc0,0xf7,0x47,0x9f,0xb0,0x2f,0x02,0x00,0x5e,0x03,0xbe,0x31,0xfa,
+0x96,0xd7,0x57,0x00,0x30,0x1f,0x80,0x11,0xdd,0xa5,0x8c,0xef,0x00,0x80,0xdd,0x00,
+0x88,0x8c,0x8c,0x65,0x66,0x06,0x00,0xce,0xc7,0x3f,0xf4,0x7f,0x09,0xb9,0x33,0x00,
+0x38,0x0b,0x80,0x34,0x22,0x72,0x10,0x01,0x01,0x00,0x59,0x01,0x34,0x93,0x88,0x42,
+0xc8,0x08,0x00,0x10,0x01,0xfc,0xff,0xe1,0xe1,0xe1,0xfe,0xf0,0x00,0xff,0xe3,0x03,
+0x3e,0x3f,0xfa,0x84,0x7d,0x11,0x00,0x10,0x1f,0xf0,0x99,0xd1,0xb7,0xbc,0xbe,0x02,
+0x80,0x0c,0x00,0x8c,0xe0,0x2e,0x65,0x7c,0x07,0x00,0xc4,0x07,0x40,0x60,0x64,0x2c,
+0x33,0x33,0x00,0x30,0x3d,0xfe,0xa3,0xff,0x4b,0xd0,0x9d,0x01,0xc0,0xf1,0x01,0x7c,
+0x10,0x99,0x8b,0x0c,0x08,0x00,0x88,0x0f,0x60,0x77,0xcc,0x54,0x46,0x46,0x00,0x00,
+0x09,0xe0,0xff,0x0f,0x0f,0x0f,0xf7,0x87,0x07,0xf8,0x3f,0x1f,0xf0,0xfd,0xd1,0x27,
+0xec,0x8b,0x00,0x80,0x4e,0x80,0xaf,0x88,0xbe,0xe4,0xf5,0x15,0x00,0x74,0x06,0x60,
+0x44,0x72,0x29,0xe3,0x3b,0x00,0xa0,0x23,0x00,0x22,0x23,0x63,0x99,0x99,0x01,0x80,
+0xf3,0xf1,0x0f,0xfd,0x5f,0xc2,0xee,0x0c,0x00,0x96,0x0f,0xe0,0x8f,0xc8,0x5c,0x64,
+0x40,0x00,0x40,0x16,0x00,0xa9,0x22,0xa2,0x10,0x32,0x02,0x00,0x4c,0x40,0xec,0x7f,
+0x78,0x78,0xb8,0x3f,0x3c,0xc0,0xff,0x02,0x80,0x2f,0x8e,0x3e,0x61,0x5f,0x04,0x00,
+0xc4,0x07,0x7c,0x66,0xf4,0x2d,0xaf,0xaf,0x00,0x20,0x3e,0x00,0x23,0xaa,0x4b,0x19,
+0xdf,0x01,0x00,0xf1,0x01,0x10,0x11,0x19,0xcb,0xcc,0x0c,0x00,0x2c,0x8f,0xff,0xe8,
+0xff,0x12,0x76,0x67,0x00,0x50,0x4b,0x00,0x7b,0x44,0xe6,0x22,0x03,0x02,0x00,0xe2,
+0x03,0xf8,0x2e,0x33,0x95,0x91,0x11,0x00,0x80,0x02,0xf9,0xff,0xc3,0xc3,0xc3,0xfd,
+0xe1,0x01,0xfe,0x67,0x06,0x7c,0x5f,0xf4,0x09,0xfb,0x02,0x00,0x20,0x2b,0xe0,0x3b,
+0xa3,0x2f,0x79,0x7d,0x05,0x00,0x2f,0x00,0x18,0x91,0x5d,0xca,0xf8,0x0e,0x00,0x98,
+0x0f,0x80,0x48,0xc8,0x58,0x66,0x66,0x00,0xe0,0x62,0xfc,0x43,0xff,0x97,0xb0,0x1b,
+0x03,0x80,0xe7,0x03,0xf8,0x23,0x32,0x17,0x19,0x10,0x00,0x30,0x1f,0xc0,0xff,0x99,
+0xa9,0x8c,0x8c,0x00,0x00,0x15,0xa0,0xfe,0x1f,0x1e,0x1e,0xee,0x0f,0x0f,0xf0,0x3f,
+0x3e,0xe0,0xfb,0xa3,0x4f,0xd8,0x17,0x01,0x00,0xf1,0x01,0x5f,0x11,0x7d,0xcb,0xeb,
+0x2b,0x00,0x88,0x0f,0xc0,0x88,0xea,0x52,0xc6,0x76,0x00,0x40,0x39,0x00,0x44,0x44,
+0xc6,0x32,0x33,0x03,0x00,0xe3,0xe3,0x3f,0xfa,0xbf,0x84,0x5d,0x19,0x00,0x5c,0x18,
+0xc0,0x1d,0x91,0xb9,0xc8,0x80,0x00,0x80,0x6a,0x00,0xf6,0xcf,0x4c,0x65,0x64,0x04,
+0x00,0xb0,0x80,0xdf,0xff,0xf0,0xf0,0x70,0x7f,0x78,0x80,0xff,0x07,0x01,0xdf,0x1f,
+0x7d,0xc2,0xbe,0x00,0x00,0xa8,0x02,0xf8,0xce,0xe8,0x53,0x5e,0x5f,0x01,0xc0,0x7c,
+0x00,0x46,0x44,0x84,0x22,0x3e,0x02,0x00,0xaa,0x00,0x20,0x32,0x32,0x94,0x99,0x19,
+0x00,0x38,0x1f,0xff,0xd0,0xff,0x25,0x6c,0xce,0x00,0xe0,0xf9,0x00,0xfe,0x88,0xcc,
+0x45,0x06,0x04,0x00,0xcc,0x07,0xf0,0x7f,0x66,0x2a,0x23,0x23,0x00,0xc0,0x05,0xf0,
+0xff,0x87,0x87,0x87,0xfb,0xc3,0x03,0xfc,0x8f,0x0f,0xf8,0xbe,0xe8,0x13,0xf6,0x45,
+0x00,0x40,0x7c,0xc0,0x77,0x46,0xdf,0xf2,0xfa,0x0a,0x00,0x52,0x00,0x30,0xa2,0x99,
+0x94,0xf0,0x0d,0x00,0x10,0x1f,0x00,0x91,0x91,0xb1,0xcc,0xcc,0x00,0xc0,0x8a,0xf8,
+0x8f,0xfe,0x2f,0x61,0x75,0x06,0x00,0xa7,0x07,0xf0,0x46,0x64,0x2e,0x32,0x20,0x00,
+0xa0,0x38,0x80,0xfb,0x33,0x53,0x19,0x19,0x01,0x00,0x30,0x40,0x02,0xc0,0xff,0xff,
+0x03,0xfe,0xff,0x1f,0x80,0x52,0xc0,0xf7,0x43,0x9f,0xb0,0x2f,0x02,0x00,0xe6,0x03,
+0xbe,0x13,0xfa,0x96,0xd7,0x57,0x00,0x10,0x1f,0x80,0x11,0x9d,0xa4,0x8c,0xef,0x00,
+0x80,0xf9,0x00,0x88,0x8c,0x84,0x65,0x66,0x06,0x00,0xce,0xc7,0x3f,0xb4,0x7f,0x09,
+0xbb,0x33,0x00,0x78,0x3e,0x80,0x3f,0x22,0x73,0x91,0x01,0x01,0x00,0xf3,0x01,0xfc,
+0x9f,0x99,0xca,0xc8,0x08,0x00,0x90,0x01,0x7c,0x00,0xfe,0xff,0x1f,0xf0,0xff,0xff,
+0x00,0xe0,0x03,0xbe,0x3f,0xfa,0x84,0x7d,0x11,0x00,0x90,0x13,0xf0,0x1d,0xd1,0xb7,
+0xbc,0xbe,0x02,0x80,0x4c,0x00,0x8c,0xe8,0x2a,0x65,0x7c,0x07,0x00,0xb4,0x04,0x40,
+0x64,0x44,0x2c,0x33,0x33,0x00,0xb0,0x36,0xfe,0xa3,0xfe,0x4b,0xd8,0x9d,0x01,0xc0,
+0x29,0x00,0x7c,0x11,0x99,0x8b,0x0c,0x08,0x00,0xe8,0x06,0xe0,0xfd,0xcc,0x54,0x46,
+0x46,0x00,0x00,0x0d,0xe0,0x03,0x70,0x77,0x77,0x80,0xbb,0xbb,0x03,0xe0,0x01,0xf0,
+0xfd,0xd1,0x27,0xec,0x8b,0x00,0x80,0xa5,0x80,0xef,0x88,0xbe,0xe4,0xf5,0x15,0x00,
+0xac,0x04,0x60,0x44,0x67,0x29,0xe3,0x3b,0x00,0x20,0x3e,0x00,0x22,0x23,0x62,0x99,
+0x99,0x01,0x80,0xf3,0xf1,0x0f,0xfd,0x5f,0xc2,0xee,0x0c,0x00,0x9e,0x0f,0xe0,0x8f,
+0xc8,0x5c,0x64,0x40,0x00,0xc0,0x7c,0x00,0xff,0x67,0xa6,0x32,0x32,0x02,0x00,0x6c,
+0x40,0x16,0x80,0xff,0xff,0x07,0xfc,0xff,0x3f,0x00,0xf8,0x80,0xef,0x0f,0x3e,0x61,
+0x5f,0x04,0x00,0xc4,0x07,0x7c,0x67,0xf4,0x2d,0xaf,0xaf,0x00,0x20,0x3e,0x00,0x23,
+0xba,0x4a,0x19,0xcf,0x01,0x00,0x75,0x01,0x10,0x19,0x19,0xcb,0xcc,0x0c,0x00,0xcc,
+0x8b,0xff,0xe8,0xff,0x12,0x76,0x67,0x00,0x70,0x39,0x00,0x3f,0x44,0xe6,0x22,0x03,
+0x02,0x00,0xb2,0x03,0xf8,0x3d,0x33,0x95,0x91,0x11,0x00,0x80,0x03,0x23,0x00,0xec,
+0xee,0x2e,0x60,0x77,0x77,0x01,0x58,0x06,0x7c,0x7f,0xf4,0x09,0xfb,0x22,0x00,0xa0,
+0x0b,0xe0,0x3b,0xa3,0x6f,0x79,0x7d,0x05,0x00,0xf1,0x01,0x18,0xd1,0x1d,0x4a,0xf8,
+0x0e,0x00,0x88,0x0f,0x80,0xc8,0xc8,0x58,0x66,0x66,0x00,0x60,0x47,0xfc,0x47,0xfe,
+0x87,0x30,0x33,0x03,0x00,0xd3,0x00,0xf8,0x23,0x32,0x17,0x11,0x10,0x00,0x30,0x1f,
+0xc0,0xff,0x99,0xa9,0x8c,0x8c,0x00,0x00,0x1d,0xc0,0x07,0xe0,0xff,0xff,0x01,0xff,
+0xff,0x0f,0x00,0x3e,0xe0,0xfb,0x83,0x4f,0xd8,0x07,0x01,0x00,0xf1,0x01,0xdf,0x11,
+0x7d,0xc9,0xeb,0x2b,0x00,0xe8,0x0c,0xc0,0x88,0xee,0x52,0xc4,0x77,0x00,0x40,0x26,
+0x00,0x44,0x46,0xc2,0x32,0x33,0x03,0x00,0xe3,0xe3,0x3f,0xca,0xbf,0x04,0x44,0x18,
+0x00,0x04,0x1f,0xc0,0x1f,0x90,0xb9,0xc8,0x80,0x00,0x80,0xe6,0x00,0xfe,0xce,0x4c,
+0x65,0x64,0x04,0x00,0xf0,0x40,0xfe,0xff,0xf0,0xf0,0x70,0x7f,0x78,0x80,0xff,0x27,
+0x00,0xdf,0x1f,0x7d,0xc2,0xbe,0x08,0x00,0xc8,0x02,0xf8,0x8e,0xe8,0x4b,0x5e,0x5f,
+0x01,0xc0,0x69,0x00,0x46,0x74,0x87,0x32,0xbe,0x03,0x00,0xe6,0x03,0x20,0x32,0x32,
+0x16,0x11,0x11,0x00,0x78,0x02,0xff,0xd1,0x3f,0x24,0xec,0xce,0x00,0xe0,0xf9,0x00,
+0xfe,0x88,0xcc,0x45,0x06,0x04,0x00,0xcc,0x07,0xf0,0x7f,0x66,0x2a,0x23,0x23,0x00,
+0xc0,0x07,0xb8,0xfe,0x87,0x87,0x87,0xfb,0xc3,0x03,0xfc,0x8f,0x0f,0xf8,0xfe,0xe0,
+0x13,0xf6,0x41,0x00,0x00,0x7c,0xc0,0x77,0x46,0xdf,0xf2,0xfa,0x0a,0x00,0xe2,0x03,
+0x30,0xa2,0xbb,0x14,0x71,0x1d,0x00,0xd0,0x11,0x00,0x91,0x91,0xb1,0x44,0x44,0x00,
+0xc0,0xf8,0xf8,0x8f,0xee,0x2e,0x61,0x77,0x06,0x00,0xd7,0x01,0xf0,0x47,0x60,0x2e,
+0x32,0x20,0x00,0x20,0x2f,0x80,0x7f,0x33,0x53,0x19,0x19,0x01,0x00,0x40,0x90,0xff,
+0x3f,0x3c,0x3c,0xdc,0x1f,0x1e,0xe0,0xff,0x7c,0xc0,0xf7,0x47,0x9f,0xb0,0x2f,0x02,
+0x00,0xe2,0x03,0xbe,0x33,0xfa,0x96,0xd7,0x57,0x00,0xf0,0x0b,0x80,0x11,0xdd,0xa5,
+0x0c,0xef,0x00,0x00,0xf8,0x00,0x88,0x8c,0x8c,0x25,0x62,0x06,0x00,0xce,0xc7,0x7f,
+0x74,0x66,0x09,0xbb,0x33,0x00,0x78,0x3e,0x80,0x3f,0x22,0x73,0x91,0x01,0x01,0x00,
+0xf3,0x01,0xfc,0x9f,0x99,0xca,0xc8,0x08,0x00,0x10,0x02,0x8d,0xff,0xe1,0xe1,0xe1,
+0xfe,0xf0,0x00,0xff,0x8b,0x02,0xbe,0x3f,0xf8,0x84,0x7d,0x10,0x00,0xc0,0x19,0xf0,
+0x9d,0xd0,0xb7,0xbc,0xbe,0x02,0x80,0xf8,0x00,0x8c,0xe8,0x2e,0x65,0x7c,0x07,0x00,
+0x24,0x06,0x40,0x64,0x64,0x2c,0x33,0x33,0x00,0xb0,0x1b,0xfe,0xa3,0xcf,0x48,0xd8,
+0x9d,0x01,0xc0,0x1d,0x01,0xfc,0x11,0x98,0x8b,0x0c,0x08,0x00,0xc8,0x09,0xe0,0x7f,
+0xcc,0x54,0x46,0x46,0x00,0x00,0x11,0xe4,0xff,0x0f,0x0f,0x0f,0xf7,0x87,0x07,0xf8,
+0x3f,0x1f,0xf0,0xfd,0xd1,0x27,0xec,0x8b,0x00,0x80,0xf8,0x80,0xef,0x8c,0xbe,0xe5,
+0xf5,0x15,0x00,0xdc,0x05,0x60,0x44,0x77,0x29,0xc3,0x3b,0x00,0x40,0x3e,0x00,0x22,
+0x23,0x63,0x19,0x98,0x01,0x80,0xf3,0xf1,0x1f,0x5d,0x55,0xc2,0xee,0x0c,0x00,0xae,
+0x02,0xe0,0x8f,0xc8,0x54,0x64,0x40,0x00,0xc0,0x7c,0x00,0xff,0x67,0xa6,0x32,0x32,
+0x02,0x00,0x8c,0xc0,0xe7,0x7f,0x78,0x78,0xb8,0x3f,0x3c,0xc0,0xff,0x3a,0x80,0xef,
+0x0f,0x3e,0x21,0x1f,0x04,0x00,0xd0,0x05,0x7c,0x67,0xf0,0x2d,0xaf,0x8f,0x00,0x20,
+0x3e,0x00,0x23,0xba,0x4b,0x19,0xdf,0x01,0x00,0x19,0x00,0x10,0x19,0x19,0xcb,0xcc,
+0x0c,0x00,0x6c,0x8a,0xff,0xe8,0x55,0x12,0x76,0x67,0x00,0x70,0x7c,0x00,0x7f,0x44,
+0xe6,0x22,0x03,0x02,0x00,0x12,0x02,0xf8,0x3f,0x32,0x95,0x91,0x11,0x00,0x80,0x04,
+0x27,0xff,0xc3,0xc3,0xc3,0xfd,0xe1,0x01,0xfe,0xc7,0x07,0x7c,0x7f,0xf4,0x09,0xfb,
+0x22,0x00,0xa0,0x25,0xe0,0x3b,0xa3,0x6f,0x79,0x7d,0x05,0x00,0x7b,0x00,0x18,0xd1,
+0x5d,0xca,0xf0,0x0e,0x00,0xa0,0x0a,0x80,0xc8,0xc8,0x58,0x66,0x66,0x00,0xe0,0x65,
+0xfc,0x47,0xff,0x91,0xb0,0x3b,0x03,0x80,0xe7,0x03,0xf8,0x23,0x12,0x17,0x19,0x10,
+0x00,0x30,0x1f,0xc0,0xff,0x99,0xa9,0x8c,0x8c,0x00,0x00,0x25,0xc0,0xff,0x1f,0x1e,
+0x1e,0xee,0x0f,0x0f,0xf0,0xbf,0x2f,0xe0,0xfb,0x23,0x4f,0xd8,0x17,0x01,0x00,0xf1,
+0x01,0xdf,0x19,0x79,0xcb,0xeb,0x2b,0x00,0x88,0x0f,0xc0,0x88,0xee,0x52,0xc6,0x77,
+0x00,0x40,0x7c,0x00,0x44,0x46,0xc6,0x32,0x23,0x03,0x00,0xe3,0xe3,0x3f,0x7a,0xb7,
+0x84,0xdd,0x19,0x00,0x9c,0x1d,0xc0,0x1f,0x11,0xb9,0xc8,0x80,0x00,0x80,0xf2,0x00,
+0xfe,0x4f,0x4c,0x65,0x64,0x04,0x00,0x30,0x41,0x3e,0x00,0xdd,0xdd,0x0d,0xe8,0xee,
+0x6e,0x00,0xf2,0x01,0xdf,0x1f,0x7d,0xc2,0xbe,0x08,0x00,0x98,0x0f,0xf8,0xce,0xe8,
+0x5b,0x5e,0x5f,0x01,0xc0,0x2d,0x00,0x46,0x74,0x97,0x32,0xbc,0x03,0x00,0xe4,0x03,
+0x20,0x32,0x32,0x96,0x99,0x19,0x00,0xf8,0x01,0xff,0xd1,0xff,0x24,0xec,0xce,0x00,
+0xe0,0x52,0x00,0xfe,0x88,0xc8,0x45,0x06,0x04,0x00,0xcc,0x07,0xf0,0x7f,0x66,0x2a,
+0x23,0x23,0x00,0xc0,0x09,0xbc,0x01,0xf8,0xff,0x7f,0xc0,0xff,0xff,0x03,0x20,0x0c,
+0xf8,0xfe,0x28,0x12,0xf6,0x45,0x00,0x40,0x03,0xc0,0x77,0x46,0xd1,0xf2,0xfa,0x0a,
+0x00,0xe2,0x03,0x30,0xa2,0xbb,0x94,0xf1,0x1d,0x00,0x50,0x14,0x00,0x91,0x91,0xb1,
+0xcc,0xc4,0x00,0xc0,0xf8,0xf8,0x8f,0xbe,0x2b,0x61,0x77,0x06,0x00,0xc7,0x07,0xf0,
+0x47,0x64,0x2e,0x30,0x20,0x00,0xa0,0x00,0x80,0xff,0x33,0x52,0x19,0x19,0x01,0x00,
+0x50,0xb0,0x00,0x80,0xbb,0xbb,0x03,0xdc,0xdd,0x1d,0x00,0x17,0xc0,0xf7,0x47,0x9f,
+0xa0,0x2f,0x02,0x00,0x4a,0x01,0xbe,0x33,0xfa,0x96,0xd7,0x57,0x00,0xf0,0x13,0x80,
+0x11,0xdd,0xa5,0x0c,0xef,0x00,0x00,0x4a,0x00,0x88,0x8c,0x8c,0x65,0x66,0x06,0x00,
+0x5c,0xc7,0x7f,0xf4,0x7f,0x09,0xbb,0x33,0x00,0xb8,0x33,0x80,0x3f,0x22,0x73,0x91,
+0x01,0x01,0x00,0xf3,0x01,0xfc,0x9f,0x99,0xca,0xc8,0x08,0x00,0x90,0x02,0x7c,0x00,
+0xfe,0xff,0x1f,0xf0,0xff,0xff,0x00,0xe0,0x03,0xbe,0x3f,0xfa,0x84,0x7d,0x11,0x00,
+0x10,0x1f,0xf0,0x9d,0xd1,0xb7,0x3c,0xbe,0x02,0x80,0xf8,0x00,0x8c,0xe8,0x2e,0x65,
+0x7c,0x07,0x00,0xc4,0x07,0x40,0x64,0x64,0x2c,0x33,0x23,0x00,0x10,0x3e,0xfe,0xa3,
+0xdf,0x49,0xd8,0x9d,0x01,0xc0,0xf1,0x01,0xfc,0x11,0x89,0x8b,0x0c,0x08,0x00,0xa8,
+0x08,0xe0,0xff,0x4c,0x54,0x46,0x46,0x00,0x00,0x15,0xbc,0x03,0xf0,0xff,0xff,0x80,
+0xff,0xff,0x07,0xc0,0x15,0xf0,0xfd,0xd1,0x27,0xec,0x8b,0x00,0x80,0xf9,0x80,0xef,
+0x8c,0xbe,0xe5,0xf5,0x15,0x00,0xcc,0x07,0x60,0x44,0x77,0x29,0xc3,0x3b,0x00,0x60,
+0x0f,0x00,0x22,0x23,0x63,0x99,0x99,0x00,0x80,0x5d,0xf0,0x1f,0xfd,0x5f,0xc2,0xee,
+0x08,0x00,0x9e,0x0f,0xe0,0x8f,0xc8,0x5c,0x24,0x40,0x00,0xc0,0x7c,0x00,0xff,0x67,
+0xa6,0x32,0x32,0x02,0x00,0xac,0x00,0x1f,0x80,0xff,0xff,0x07,0xfc,0xff,0x3f,0x00,
+0xf8,0x80,0xef,0x8f,0x3e,0x41,0x5f,0x04,0x00,0x14,0x07,0x7c,0x67,0xf4,0x2d,0xa8,
+0xaf,0x00,0x20,0x0d,0x00,0x23,0xba,0x4b,0x19,0xdf,0x01,0x00,0xf1,0x01,0x10,0x19,
+0x19,0xcb,0xcc,0x0c,0x00,0x8c,0x8f,0xff,0xe8,0xff,0x12,0x76,0x67,0x00,0x70,0x35,
+0x00,0x7f,0x44,0xe6,0x22,0x02,0x02,0x00,0x1a,0x00,0xf8,0x3f,0x33,0x15,0x91,0x11,
+0x00,0x80,0x05,0x00,0x00,0xfc,0xff,0x3f,0xe0,0xff,0xff,0x01,0xa0,0x06,0x7c,0x7f,
+0xf4,0x09,0xfb,0x22,0x00,0x60,0x3e,0xe0,0x3b,0xa3,0x6f,0x79,0x7d,0x05,0x00,0x67,
+0x00,0x18,0xd1,0x5d,0xca,0xf8,0x0c,0x00,0x98,0x0f,0x80,0xc8,0xc8,0x58,0x66,0x66,
+0x00,0x40,0x16,0xfc,0x47,0xff,0x97,0xb0,0x3b,0x03,0x80,0x33,0x01,0xf8,0x23,0x32,
+0x17,0x19,0x10,0x00,0xb0,0x18,0xc0,0xff,0x99,0xa9,0x8c,0x8c,0x00,0x00,0x2d,0x00,
+0x00,0xe0,0xff,0xff,0x01,0xff,0xff,0x0f,0x00,0x3e,0xe0,0xfb,0xa3,0x4f,0x98,0x17,
+0x01,0x00,0xc9,0x00,0xdf,0x19,0x7d,0xcb,0x2b,0x2a,0x00,0x88,0x0f,0xc0,0x88,0xee,
+0x52,0x46,0x57,0x00,0x40,0x1a,0x00,0x44,0x46,0xc6,0x32,0x33,0x03,0x00,0xe1,0xe3,
+0x3f,0xfa,0xbf,0x84,0xdd,0x11,0x00,0x1c,0x1f,0xc0,0x1f,0x91,0xb9,0x48,0x80,0x00,
+0x80,0xf8,0x00,0xfe,0xcf,0x4c,0x25,0x64,0x04,0x00,0x70,0x01,0x00,0x00,0xff,0xff,
+0x0f,0xf8,0xff,0x7f,0x00,0xf2,0x01,0xdf,0x1f,0x7d,0xc2,0xbe,0x08,0x00,0x48,0x0d,
+0xf8,0xce,0xe8,0x5b,0x5e,0x5f,0x01,0x40,0x26,0x00,0x46,0x74,0x97,0x32,0x3e,0x01,
+0x00,0xe2,0x03,0x20,0x32,0x32,0x96,0x99,0x19,0x00,0x38,0x1f,0xff,0xd1,0xff,0x25,
+0xec,0x8e,0x00,0xe0,0x92,0x00,0xfe,0x88,0xcc,0x45,0x06,0x04,0x00,0xb4,0x04,0xf0,
+0x7f,0x66,0x2a,0x23,0x23,0x00,0xc0,0x0b,0x00,0x00,0xf8,0xff,0x7f,0xc0,0xff,0xff,
+0x03,0x40,0x08,0xf8,0xfe,0xe8,0x13,0x16,0x45,0x00,0x40,0x7c,0xc0,0x77,0x46,0xdf,
+0xf2,0xfa,0x0a,0x00,0xe0,0x03,0x30,0xa2,0xbb,0x94,0xf1,0x15,0x00,0x10,0x1f,0x00,
+0x91,0x91,0xb1,0xcc,0xcc,0x00,0xc0,0x8e,0xf8,0x8f,0xfe,0x2f,0x61,0x77,0x02,0x00,
+0xc7,0x07,0xf0,0x47,0x64,0x2e,0x32,0x20,0x00,0x00,0x3e,0x80,0xff,0x33,0x53,0x19,
+0x19,0x00,0x00,0x60,0x00,0x00,0x80,0x99,0x99,0x11,0xcc,0x0c,0x00,0x00,0x00,0x00,
+0xd4,0x44,0x0d,0xa0,0x26,0x42,0x00,0x00,0x00,0xa0,0x22,0x6a,0x00,0x2b,0x2b,0x02,
+0x00,0x00,0x00,0x11,0x55,0x05,0x88,0xaa,0x10,0x00,0x00,0x00,0x88,0x88,0x08,0x40,
+0x44,0x84,0x00,0x00,0x00,0x40,0x54,0x55,0x01,0xaa,0x22,0x04,0x00,0x00,0x00,0x2a,
+0x22,0x02,0x10,0x01,0x21,0x00,0x00,0x00,0x50,0x15,0x11,0x80,0x88,0x08,0x00,0x10,
+0x03,0x00,0x00,0x44,0x44,0x04,0x20,0x22,0x00,0x00,0x00,0x00,0x20,0x22,0x22,0x02,
+0x11,0x11,0x01,0x00,0x00,0x00,0x11,0x10,0x11,0x88,0x88,0x08,0x00,0x00,0x00,0x88,
+0x88,0x88,0x40,0x44,0x44,0x00,0x00,0x00,0x40,0x44,0x00,0x04,0x22,0x22,0x02,0x00,
+0x00,0x00,0x22,0x22,0x22,0x10,0x11,0x11,0x00,0x00,0x00,0x30,0x13,0x01,0x81,0x80,
+0x88,0x00,0x00,0x00,0x80,0x99,0x99,0x09,0x0c,0x44,0x00,0x00,0x19,0x00,0x00,0x80,
+0x88,0x88,0x00,0x44,0x9c,0x01,0x00,0x00,0x00,0x33,0x33,0x03,0x80,0x19,0x18,0x00,
+0x00,0x00,0x18,0x98,0x19,0xc0,0xcc,0xcc,0x00,0x00,0x00,0xc0,0xcc,0xcc,0x00,0x66,
+0x60,0x06,0x00,0x00,0x00,0x06,0x66,0x06,0x00,0x03,0x30,0x00,0x00,0x00,0x10,0x30,
+0x33,0x80,0x99,0x81,0x01,0x00,0x00,0x80,0x88,0x99,0x01,0xcc,0xcc,0x0c,0x00,0x00,
+0x00,0x44,0x44,0x04,0x20,0x68,0x36,0x00,0xcc,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+0x80,0x08,0x00,0x00,0x00,0x88,0x20,0x08,0x00,0x04,0x10,0x00,0x00,0x00,0x60,0x00,
+0x64,0x00,0x03,0x23,0x02,0x00,0x00,0x00,0x2a,0x30,0x03,0x18,0x81,0x11,0x00,0x00,
+0x00,0x10,0x84,0x01,0x00,0x22,0x00,0x00,0x00,0x00,0x00,0x82,0x00,0x00,0x44,0x04,
+0x04,0x00,0x00,0x00,0xcc,0x06,0x00,0x30,0x80,0x30,0x00,0x00,0x00,0x60,0x66,0x66,
+0x00,0x03,0x1c,0x00,0x80,0x06,0x00,0x00,0xcc,0xcc,0x0c,0x60,0x66,0x00,0x00,0x00,
+0x00,0x60,0x66,0x76,0x00,0x33,0x3b,0x0b,0x00,0x00,0x00,0x33,0x3a,0x03,0x98,0x9d,
+0x19,0x00,0x00,0x00,0xd8,0xd9,0x19,0xc0,0xec,0xcc,0x02,0x00,0x00,0xc0,0xcc,0x8a,
+0x02,0x66,0x66,0x16,0x00,0x00,0x00,0x66,0x76,0x06,0xb0,0xbb,0xb3,0x00,0x00,0x00,
+0x30,0x33,0xab,0x80,0xd1,0xdd,0x01,0x00,0x00,0x80,0x99,0x99,0x01,0xcc,0xcc,0x00,
+0x00,0x35,0xd0,0x81,0x0f,0x00,};
+
+/* TMS run lengths, alternating, first run TMS=0 */
+static const u_int16 M47_FlexzTms[] = {
+0,5,1,2,6,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,1,607,2,1,1,607,2,1,1,
+607,2,1,2,6,2,1,2,6,2,1,5,
+1,};
+/** NOTE: This File was created by m47_flexsim -g **/
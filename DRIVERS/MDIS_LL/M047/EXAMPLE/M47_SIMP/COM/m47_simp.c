@@ -128,7 +128,7 @@ static int _m47_simple( char *devName, int32 ch )
 	u_int32 currVal;
 	char *device;
 	int i;
-	u_int32 dummy[M47_MAX_CH];
+	int32 gen;
 	device = devName;
 	chan = ch;
 
@@ -171,12 +171,9 @@ static int _m47_simple( char *devName, int32 ch )
 		goto abort;
 	}
 	
-	/* wait for configuration to take effect */
-	UOS_MikroDelay( 1600 );
-	
-	/* perform dummy read from all channels to initialize buffer register */
-	if (M_getblock( path, (u_int8*) dummy, M47_MAX_CH * sizeof (u_int32)) < 0){
-		PrintError("getblock");
+	/* wait for the first frame with the new configuration */
+	if (M_getstat(path, M47_WAIT_VALID, &gen) < 0) {
+		PrintError("getstat M47_WAIT_VALID");
 		goto abort;
 	}
 	
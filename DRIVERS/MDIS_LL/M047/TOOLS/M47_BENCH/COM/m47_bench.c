@@ -0,0 +1,276 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   M47_BENCH                        ************
+ ************                                                    ************
+ ****************************************************************************
+ *
+ *       Author: ag
+ *
+ *  Description: Benchmark program for the M47 driver
+ *
+ *               Measures the average wall time per call of M_getblock
+ *               (snapshot and coherent snapshot mode) and M_read in us
+ *               and, on x86 with GCC, in time stamp counter cycles. Each
+ *               test repeats batches of <loops> calls until at least
+ *               MIN_TEST_MS have passed, so the 1 ms timer resolution
+ *               adds less than 0.1% error. Run it once against a device
+ *               using the standard driver (m47) and once against a device
+ *               using the production driver (m47_fast) to compare both
+ *               builds.
+ *
+ *     Required: libraries: mdis_api, usr_oss
+ *     Switches: -
+ *
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+ /*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <MEN/men_typs.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <MEN/usr_oss.h>
+#include <MEN/mdis_api.h>
+#include <MEN/mdis_err.h>
+#include <MEN/m47_drv.h>
+
+static const char IdentString[]=MENT_XSTR(MAK_REVISION);
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define M47_MAX_CH      4
+#define LOOPS_DEFAULT   1000
+#define MIN_TEST_MS     1000	/* min. duration of each test [ms] */
+
+/* calls under test */
+#define CALL_GETBLOCK   0
+#define CALL_READ       1
+
+/* cycle counter */
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+# define HAVE_CYCLES
+#endif
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static void PrintError(char *info);
+static int TimeCalls(MDIS_PATH path, int call, void *buf, int32 size,
+					 int32 loops, double *usP, double *cyclesP,
+					 u_int32 *callsP);
+#ifdef HAVE_CYCLES
+static u_int64 Cycles(void);
+#endif
+
+
+/********************************* main *************************************
+ *
+ *  Description: Program main function
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: argc,argv	argument counter, data ..
+ *  Output.....: return	    success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+int main(int argc, char *argv[])
+{
+	MDIS_PATH path;
+	u_int32 data[M47_MAX_CH];
+	M47_SNAPSHOT snap;
+	int32 value, loops;
+	u_int32 blkCalls, cohCalls, rdCalls;
+	double blkUs, cohUs, rdUs;
+	double blkCyc, cohCyc, rdCyc;
+
+	if (argc < 2 || strcmp(argv[1],"-?")==0) {
+		printf("Syntax: m47_bench <device> [<loops>]\n");
+		printf("Function: M47 driver benchmark (M_getblock, M_read)\n");
+		printf("Option:\n");
+		printf("    device       device name\n");
+		printf("    loops        calls per batch [%d], batches repeat\n",
+			   LOOPS_DEFAULT);
+		printf("                 for at least %d ms per test\n",
+			   MIN_TEST_MS);
+		printf("\n");
+		printf("%s\n", IdentString );
+		printf("Build %s %s\n", __DATE__, __TIME__ );
+		printf("\n");
+		return(1);
+	}
+
+	loops = (argc > 2) ? atoi(argv[2]) : LOOPS_DEFAULT;
+	if (loops <= 0)
+		loops = LOOPS_DEFAULT;
+
+	if ((path = M_open(argv[1])) < 0) {
+		PrintError("open");
+		return(1);
+	}
+
+	/* snapshot mode, channel 0 */
+	if ((M_setstat(path, M47_BLKRD_MODE, M47_BLKRD_SNAPSHOT)) < 0 ||
+		(M_setstat(path, M_MK_CH_CURRENT, 0)) < 0) {
+		PrintError("setstat");
+		goto abort;
+	}
+
+	/*--------------------+
+	|  M_getblock         |
+	+--------------------*/
+	if (TimeCalls(path, CALL_GETBLOCK, data, sizeof(data), loops,
+				  &blkUs, &blkCyc, &blkCalls))
+		goto abort;
+
+	/*--------------------+
+	|  M_getblock         |
+	|  (coherent)         |
+	+--------------------*/
+	if ((M_setstat(path, M47_BLKRD_MODE, M47_BLKRD_COHERENT)) < 0) {
+		PrintError("setstat");
+		goto abort;
+	}
+
+	if (TimeCalls(path, CALL_GETBLOCK, &snap, sizeof(snap), loops,
+				  &cohUs, &cohCyc, &cohCalls))
+		goto abort;
+
+	/*--------------------+
+	|  M_read             |
+	+--------------------*/
+	if (TimeCalls(path, CALL_READ, &value, sizeof(value), loops,
+				  &rdUs, &rdCyc, &rdCalls))
+		goto abort;
+
+	printf("Average wall time per call:\n");
+	printf("  M_getblock: %10.3f us %10.0f cycles (%lu calls)\n",
+		   blkUs, blkCyc, blkCalls);
+	printf("  coherent  : %10.3f us %10.0f cycles (%lu calls, "
+		   "skew %lu accesses, %lu retries)\n",
+		   cohUs, cohCyc, cohCalls, snap.skew, snap.retries);
+	printf("  M_read    : %10.3f us %10.0f cycles (%lu calls)\n",
+		   rdUs, rdCyc, rdCalls);
+#ifndef HAVE_CYCLES
+	printf("(no cycle counter on this platform)\n");
+#endif
+
+	if (M_close(path) < 0) {
+		PrintError("close");
+		return(1);
+	}
+	return(0);
+
+ abort:
+	M_close(path);
+	return(1);
+}
+
+/********************************* TimeCalls ********************************
+ *
+ *  Description: Measure the average wall time of a call
+ *
+ *               Repeats batches of <loops> calls until MIN_TEST_MS have
+ *               passed on the millisecond timer. The cycle counter runs
+ *               over the same interval.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: path	path
+ *               call	CALL_GETBLOCK or CALL_READ
+ *               buf	data buffer
+ *               size	data buffer size
+ *               loops	calls per batch
+ *  Output.....: *usP	average time per call [us]
+ *               *cyclesP	average cycles per call (0 = no counter)
+ *               *callsP	number of calls done
+ *               return	success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+static int TimeCalls(MDIS_PATH path, int call, void *buf, int32 size,
+					 int32 loops, double *usP, double *cyclesP,
+					 u_int32 *callsP)
+{
+	u_int32 start, elapsed, calls = 0;
+	int32 i;
+#ifdef HAVE_CYCLES
+	u_int64 cycStart = Cycles();
+#endif
+
+	start = UOS_MsecTimerGet();
+	do {
+		for (i = 0; i < loops; i++) {
+			if (call == CALL_GETBLOCK) {
+				if (M_getblock(path, (u_int8*)buf, size) < 0) {
+					PrintError("getblock");
+					return(1);
+				}
+			}
+			else if (M_read(path, (int32*)buf) < 0) {
+				PrintError("read");
+				return(1);
+			}
+		}
+		calls += loops;
+		elapsed = UOS_MsecTimerGet() - start;
+	} while (elapsed < MIN_TEST_MS);
+
+	*usP    = (double)elapsed * 1000.0 / calls;
+#ifdef HAVE_CYCLES
+	*cyclesP = (double)(Cycles() - cycStart) / calls;
+#else
+	*cyclesP = 0;
+#endif
+	*callsP = calls;
+	return(0);
+}
+
+#ifdef HAVE_CYCLES
+/********************************* Cycles ***********************************
+ *
+ *  Description: Read the x86 time stamp counter
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return	counter value [cycles]
+ *  Globals....: -
+ ****************************************************************************/
+static u_int64 Cycles(void)
+{
+	u_int32 lo, hi;
+
+	__asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+	return(((u_int64)hi << 32) | lo);
+}
+#endif /* HAVE_CYCLES */
+
+/********************************* PrintError *******************************
+ *
+ *  Description: Print MDIS error message
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: info	info string
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void PrintError(char *info)
+{
+	printf("*** can't %s: %s\n", info, M_errstring(UOS_ErrnoGet()));
+}
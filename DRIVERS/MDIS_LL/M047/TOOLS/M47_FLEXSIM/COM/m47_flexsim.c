@@ -0,0 +1,458 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   M47_FLEXSIM                      ************
+ ************                                                    ************
+ ****************************************************************************
+ *
+ *       Author: ag
+ *
+ *  Description: FLEXlogic bitstream generator, simulator and benchmark
+ *
+ *               Runs the original m47_flexload algorithm on m47_flex.h
+ *               and the driver's loaders (M47_FlexLoadZ() on m47_flexz.h,
+ *               M47_FlexLoadRaw() on m47_flex.h) against a simulated
+ *               FLEXREG, checks that they emit the identical write
+ *               sequence (JTAG waveform) and reports bus writes and CPU
+ *               time per load.
+ *
+ *               With -g the compressed m47_flexz.h is generated from
+ *               m47_flex.h. Rerun it whenever m47_flex.h changes.
+ *
+ *               Needs no hardware and no driver.
+ *
+ *     Required: libraries: -
+ *     Switches: -
+ *
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+ /*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <MEN/men_typs.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char IdentString[]=MENT_XSTR(MAK_REVISION);
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define LOOPS_DEFAULT   100
+#define FLEXREG         0xde
+
+/* simulated FLEXREG: record or count writes */
+typedef struct {
+	u_int16 *buf;		/* recorded values, NULL = count only */
+	u_int32 size;		/* size of buf [entries] */
+	u_int32 count;		/* number of writes */
+} SIM_BUS;
+
+typedef SIM_BUS *MACCESS;
+
+#define MWRITE_D16(ma,offs,val) \
+	do { \
+		if ((ma)->buf && (ma)->count < (ma)->size) \
+			(ma)->buf[(ma)->count] = (u_int16)(val); \
+		(ma)->count++; \
+	} while (0)
+
+/* original bit macros of m47_flexload */
+#define bitset(byte,mask)  ((byte) |=  (mask))
+#define bitclr(byte,mask)  ((byte) &= ~(mask))
+#define bitmove(byte,mask,bool) (bool ? bitset(byte,mask) : bitclr(byte,mask))
+
+#include "../../../DRIVER/COM/m47_flex.h"
+
+/* M47_FlexIdent of the compressed data */
+#define M47_FlexIdent	M47_FlexzIdent
+#include "../../../DRIVER/COM/m47_flexz.h"
+#undef M47_FlexIdent
+
+#include "../../../DRIVER/COM/m47_flexld.h"
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static void FlexLoadOrig( MACCESS ma );
+static void FlexLoadZ( MACCESS ma );
+static void FlexLoadZChunked( MACCESS ma );
+static void FlexLoadRaw( MACCESS ma );
+static int Compare( char *name, SIM_BUS *ref, void (*load)(MACCESS) );
+static double LoadTime( void (*load)(MACCESS), int32 loops, u_int32 *writes );
+static int Generate( char *fileName );
+
+
+/********************************* main *************************************
+ *
+ *  Description: Program main function
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: argc,argv	argument counter, data ..
+ *  Output.....: return	    success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+int main(int argc, char *argv[])
+{
+	SIM_BUS orig;
+	u_int32 wrOrig, wrComp, wrRaw, hash;
+	int32 loops = LOOPS_DEFAULT;
+	double usOrig, usComp, usRaw;
+	int rc = 0;
+
+	if (argc > 1 && strcmp(argv[1],"-?")==0) {
+		printf("Syntax: m47_flexsim [<loops>] | -g <file>\n");
+		printf("Function: M47 FLEXlogic loader check and benchmark\n");
+		printf("Option:\n");
+		printf("    loops        number of loads to time [%d]\n",
+			   LOOPS_DEFAULT);
+		printf("    -g <file>    generate compressed header from m47_flex.h\n");
+		printf("\n");
+		printf("%s\n", IdentString );
+		printf("Build %s %s\n", __DATE__, __TIME__ );
+		printf("\n");
+		return(1);
+	}
+
+	if (argc > 2 && strcmp(argv[1],"-g")==0)
+		return( Generate(argv[2]) );
+
+	if (argc > 1 && (loops = atoi(argv[1])) <= 0)
+		loops = LOOPS_DEFAULT;
+
+	/*--------------------+
+	|  waveform check     |
+	+--------------------*/
+	memset(&orig, 0, sizeof(orig));
+	FlexLoadOrig(&orig);		/* size the buffer */
+
+	orig.size  = orig.count;
+	orig.count = 0;
+	if ((orig.buf = (u_int16*)malloc(orig.size * sizeof(u_int16))) == NULL) {
+		printf("*** out of memory\n");
+		return(1);
+	}
+	FlexLoadOrig(&orig);
+
+	rc |= Compare("compressed", &orig, FlexLoadZ);
+	rc |= Compare("chunked", &orig, FlexLoadZChunked);
+	rc |= Compare("raw", &orig, FlexLoadRaw);
+	free(orig.buf);
+
+	hash = M47_FlexHash(M47_FlexData, sizeof(M47_FlexData));
+	if (hash != M47_FLEXZ_HASH) {
+		printf("*** hash 0x%08lx differs from m47_flexz.h (0x%08lx)\n",
+			   (unsigned long)hash, (unsigned long)M47_FLEXZ_HASH);
+		rc = 1;
+	}
+
+	/*--------------------+
+	|  benchmark          |
+	+--------------------*/
+	usOrig = LoadTime(FlexLoadOrig,  loops, &wrOrig);
+	usComp = LoadTime(FlexLoadZ,     loops, &wrComp);
+	usRaw  = LoadTime(FlexLoadRaw,   loops, &wrRaw);
+
+	printf("%ld loads each\n", (long)loops);
+	printf("  original  : %6lu bytes, %6lu writes, %10.1f us/load\n",
+		   (unsigned long)sizeof(M47_FlexData), (unsigned long)wrOrig,
+		   usOrig);
+	printf("  compressed: %6lu bytes, %6lu writes, %10.1f us/load\n",
+		   (unsigned long)(sizeof(M47_FlexzTdo) + sizeof(M47_FlexzTms)),
+		   (unsigned long)wrComp, usComp);
+	printf("  raw       : %6lu bytes, %6lu writes, %10.1f us/load\n",
+		   (unsigned long)sizeof(M47_FlexData), (unsigned long)wrRaw,
+		   usRaw);
+
+	return(rc);
+}
+
+/********************************* Compare **********************************
+ *
+ *  Description: Compare the waveform of a loader with the reference
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: name		loader name
+ *               ref		recorded reference waveform
+ *               load		loader function
+ *  Output.....: return		identical (0) or not (1)
+ *  Globals....: -
+ ****************************************************************************/
+static int Compare( char *name, SIM_BUS *ref, void (*load)(MACCESS) )
+{
+	SIM_BUS bus;
+	u_int32 i;
+	int rc = 0;
+
+	memset(&bus, 0, sizeof(bus));
+	bus.size = ref->size;
+	if ((bus.buf = (u_int16*)malloc(bus.size * sizeof(u_int16))) == NULL) {
+		printf("*** out of memory\n");
+		return(1);
+	}
+
+	load(&bus);
+
+	if (bus.count != ref->count) {
+		printf("*** %s: waveform differs: %lu/%lu writes\n", name,
+			   (unsigned long)ref->count, (unsigned long)bus.count);
+		rc = 1;
+	}
+	else {
+		for (i = 0; i < ref->count; i++) {
+			if (ref->buf[i] != bus.buf[i]) {
+				printf("*** %s: waveform differs at write %lu: 0x%x/0x%x\n",
+					   name, (unsigned long)i, ref->buf[i], bus.buf[i]);
+				rc = 1;
+				break;
+			}
+		}
+	}
+
+	if (!rc)
+		printf("%s: waveform identical (%lu writes)\n", name,
+			   (unsigned long)bus.count);
+
+	free(bus.buf);
+	return(rc);
+}
+
+/******************************* FlexLoadOrig *******************************
+ *
+ *  Description: Original m47_flexload algorithm (reference)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ma		simulated bus
+ *  Output.....: -
+ *  Globals....: M47_FlexData
+ ****************************************************************************/
+static void FlexLoadOrig( MACCESS ma )
+{
+	u_int8  ctrl, ch, n;
+	u_int8  tdo = 1 << 0;
+	u_int8  tck = 1 << 1;
+	u_int8  tms = 1 << 2;
+	u_int8  *p = (u_int8*)M47_FlexData;
+	u_int32 size;
+
+	size  = (u_int32)(*p++) << 24;
+	size |= (u_int32)(*p++) << 16;
+	size |= (u_int32)(*p++) <<  8;
+	size |= (u_int32)(*p++);
+
+	ctrl = 0x00;
+
+	while(size--) {
+		ch = *p++;
+		n = 4;
+
+		while(n--) {
+			bitclr (ctrl,tck);
+			MWRITE_D16( ma, FLEXREG, ctrl );
+
+			bitmove(ctrl,tdo,ch & 0x01);
+			bitmove(ctrl,tms,ch & 0x02);
+			MWRITE_D16( ma, FLEXREG, ctrl );
+
+			bitset (ctrl,tck);
+			MWRITE_D16( ma, FLEXREG, ctrl );
+
+			ch >>= 2;
+		}
+	}
+}
+
+/******************************** FlexLoadZ *********************************
+ *
+ *  Description: Run M47_FlexLoadZ() on m47_flexz.h in one call
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ma		simulated bus
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void FlexLoadZ( MACCESS ma )
+{
+	M47_FLEXZ_STATE st;
+
+	M47_FlexLoadZStart( &st );
+	M47_FlexLoadZ( ma, &st, M47_FLEXZ_CYCLES );
+}
+
+/***************************** FlexLoadZChunked *****************************
+ *
+ *  Description: Run M47_FlexLoadZ() on m47_flexz.h in small chunks
+ *               (as done by the driver's deferred init)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ma		simulated bus
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void FlexLoadZChunked( MACCESS ma )
+{
+	M47_FLEXZ_STATE st;
+
+	M47_FlexLoadZStart( &st );
+	while (!M47_FlexLoadZ( ma, &st, 1000 ))
+		;
+}
+
+/******************************* FlexLoadRaw ********************************
+ *
+ *  Description: Run M47_FlexLoadRaw() on m47_flex.h
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ma		simulated bus
+ *  Output.....: -
+ *  Globals....: M47_FlexData
+ ****************************************************************************/
+static void FlexLoadRaw( MACCESS ma )
+{
+	M47_FlexLoadRaw( ma, M47_FlexData + 4, sizeof(M47_FlexData) - 4 );
+}
+
+/********************************* LoadTime *********************************
+ *
+ *  Description: Measure CPU time of a loader
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: load		loader function
+ *               loops		number of loads
+ *  Output.....: writes		bus writes per load
+ *               return		CPU time per load [us]
+ *  Globals....: -
+ ****************************************************************************/
+static double LoadTime( void (*load)(MACCESS), int32 loops, u_int32 *writes )
+{
+	SIM_BUS bus;
+	clock_t start;
+	int32 i;
+
+	memset(&bus, 0, sizeof(bus));
+
+	start = clock();
+	for (i = 0; i < loops; i++)
+		load(&bus);
+
+	*writes = bus.count / loops;
+	return( (double)(clock() - start) * 1e6 / CLOCKS_PER_SEC / loops );
+}
+
+/********************************* Generate *********************************
+ *
+ *  Description: Generate m47_flexz.h from m47_flex.h
+ *
+ *               The 2 bit symbols (bit 0 = TDO, bit 1 = TMS) are split
+ *               into a TDO bit plane and TMS run lengths. TMS is almost
+ *               always 0 while data is shifted, so the runs are few.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: fileName	output file
+ *  Output.....: return		success (0) or error (1)
+ *  Globals....: M47_FlexData, M47_FlexIdent
+ ****************************************************************************/
+static int Generate( char *fileName )
+{
+	const u_int8 *p = M47_FlexData + 4;
+	u_int32 size, cycles, n, nTdo = 0, nTms = 0, run = 0;
+	u_int32 sym, tms = 0;
+	u_int8  *tdoBuf;
+	u_int16 *tmsBuf;
+	FILE *fp;
+
+	size = ((u_int32)M47_FlexData[0] << 24) | ((u_int32)M47_FlexData[1] << 16) |
+		   ((u_int32)M47_FlexData[2] <<  8) |  (u_int32)M47_FlexData[3];
+	cycles = size * 4;
+
+	tdoBuf = (u_int8*)calloc((cycles + 7) / 8, 1);
+	tmsBuf = (u_int16*)calloc(cycles + 1, sizeof(u_int16));
+	if (!tdoBuf || !tmsBuf) {
+		printf("*** out of memory\n");
+		return(1);
+	}
+
+	for (n = 0; n < cycles; n++) {
+		sym = (p[n / 4] >> ((n % 4) * 2)) & 3;
+
+		if (sym & 1)
+			tdoBuf[n / 8] |= 1 << (n % 8);
+
+		/* TMS changed or run too long: close run */
+		if ((sym >> 1) != tms) {
+			tmsBuf[nTms++] = (u_int16)run;
+			tms ^= 1;
+			run = 0;
+		}
+		else if (run == 0xffff) {
+			tmsBuf[nTms++] = (u_int16)run;
+			tmsBuf[nTms++] = 0;
+			run = 0;
+		}
+		run++;
+	}
+	tmsBuf[nTms++] = (u_int16)run;
+	nTdo = (cycles + 7) / 8;
+
+	if ((fp = fopen(fileName, "w")) == NULL) {
+		printf("*** can't create %s\n", fileName);
+		return(1);
+	}
+
+	fprintf(fp, "/*\n"
+			" *  Code that is loaded into a PLD by the driver (compressed)\n"
+			" *\n"
+			" *  Copyright 2019, MEN Mikro Elektronik GmbH\n"
+			" *\n"
+			" *  This binary code is not part of the driver and proprietary.\n"
+			" *  Reproduction and distribution is permitted for all customers\n"
+			" *  of MEN Mikro Elektronik GmbH.\n"
+			" */\n\n");
+	fprintf(fp, "static const char M47_FlexIdent[]=\"%s\";\n\n", M47_FlexIdent);
+	fprintf(fp, "/* m47_flexz: %lu JTAG cycles, %lu+%lu data bytes */\n",
+			(unsigned long)cycles, (unsigned long)nTdo,
+			(unsigned long)nTms * 2);
+	fprintf(fp, "#define M47_FLEXZ_CYCLES %lu\n", (unsigned long)cycles);
+	fprintf(fp, "#define M47_FLEXZ_HASH   0x%08lx  /* FNV-1a of m47_flex.h data */\n\n",
+			(unsigned long)M47_FlexHash(M47_FlexData, sizeof(M47_FlexData)));
+
+	fprintf(fp, "/* TDO per cycle, LSB first */\n");
+	fprintf(fp, "static const u_int8 M47_FlexzTdo[] = {");
+	for (n = 0; n < nTdo; n++)
+		fprintf(fp, "%s0x%02x,", n % 16 ? "" : "\n", tdoBuf[n]);
+	fprintf(fp, "};\n\n");
+
+	fprintf(fp, "/* TMS run lengths, alternating, first run TMS=0 */\n");
+	fprintf(fp, "static const u_int16 M47_FlexzTms[] = {");
+	for (n = 0; n < nTms; n++)
+		fprintf(fp, "%s%u,", n % 12 ? "" : "\n", tmsBuf[n]);
+	fprintf(fp, "};\n");
+	fprintf(fp, "/** NOTE: This File was created by m47_flexsim -g **/\n");
+
+	fclose(fp);
+	free(tdoBuf);
+	free(tmsBuf);
+
+	printf("%s: %lu cycles, %lu bytes (was %lu)\n", fileName,
+		   (unsigned long)cycles, (unsigned long)(nTdo + nTms * 2),
+		   (unsigned long)size + 4);
+	return(0);
+}
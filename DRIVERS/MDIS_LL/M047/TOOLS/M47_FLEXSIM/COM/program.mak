@@ -0,0 +1,41 @@
+#***************************  M a k e f i l e  *******************************
+#
+#         Author: ag
+#
+#    Description: Makefile definitions for the M47 FLEXlogic loader simulator
+#
+#-----------------------------------------------------------------------------
+#   Copyright 2026, MEN Mikro Elektronik GmbH
+#*****************************************************************************
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+MAK_NAME=m47_flexsim
+# the next line is updated during the MDIS installation
+STAMPED_REVISION="_"
+
+DEF_REVISION=MAK_REVISION=$(STAMPED_REVISION)
+MAK_SWITCH=$(SW_PREFIX)$(DEF_REVISION)
+
+MAK_LIBS=
+
+
+MAK_INCL=$(MEN_INC_DIR)/men_typs.h    \
+         $(MEN_MOD_DIR)/../../../DRIVER/COM/m47_flex.h    \
+         $(MEN_MOD_DIR)/../../../DRIVER/COM/m47_flexz.h   \
+         $(MEN_MOD_DIR)/../../../DRIVER/COM/m47_flexld.h  \
+
+MAK_INP1=m47_flexsim$(INP_SUFFIX)
+
+MAK_INP=$(MAK_INP1)
+
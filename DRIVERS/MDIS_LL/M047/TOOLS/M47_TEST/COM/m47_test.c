@@ -45,6 +45,7 @@
 static const char IdentString[]=MENT_XSTR(MAK_REVISION);
 
 static int _m47_test (char* devName);
+static int FifoTest (MDIS_PATH fd);
 static void PrintError(char *info);
 
 /********************************* main *************************************
@@ -82,7 +83,6 @@ static int _m47_test (char* devName)
 	MDIS_PATH fd;
 	int32 connect, data;
 	u_int32 singlBuf1[4];
-	u_int32 singlBuf2[4];
 	u_int32 blkBuf[4];
 	u_int32 counter;
 	int32 hwRev;
@@ -220,6 +220,10 @@ static int _m47_test (char* devName)
 	printf("press <ESC> to finish\n\n");
 	
 	
+	/* driver detects torn data words */
+	if (M_setstat(fd, M47_CONSISTENT_READ, 1) < 0)
+		goto ERR;
+
 	counter=1;
 	while(counter)
 	{
@@ -233,7 +237,6 @@ static int _m47_test (char* devName)
 			{
 				M_setstat(fd, M_MK_CH_CURRENT, chan);
 				M_read(fd, (int32*)&singlBuf1[chan]);
-				M_read(fd, (int32*)&singlBuf2[chan]);
 			}/*for*/
 		}
 		else
@@ -242,7 +245,6 @@ static int _m47_test (char* devName)
 			{
 				M_setstat(fd, M_MK_CH_CURRENT, chan);
 				M_read(fd, (int32*)&singlBuf1[chan]);
-				M_read(fd, (int32*)&singlBuf2[chan]);
 			}/*for*/
 		}/*if*/
 
@@ -254,10 +256,6 @@ static int _m47_test (char* devName)
 		/* check for equal values of each channel */
 		for( chan = 0; chan < 4; chan++ )
 		{
-			if( singlBuf1[chan] != singlBuf2[chan] )
-			{
-				printf("*** M_read     channel %ld pattern %08lX != %08lX\n", chan, singlBuf1[chan], singlBuf2[chan] ); 
-			}/*if*/
 			if( singlBuf1[chan] != blkBuf[chan] )
 			{
 				printf("*** M_getblock channel %ld pattern %08lX != %08lX\n", chan, singlBuf1[chan], blkBuf[chan] ); 
@@ -275,6 +273,16 @@ static int _m47_test (char* devName)
 		counter++;
 	}/*while*/
 
+	/* torn data words detected by the driver */
+	for( chan = 0; chan < 4; chan++ )
+	{
+		M_setstat(fd, M_MK_CH_CURRENT, chan);
+		if (M_getstat(fd, M47_TEAR_COUNT, &data) < 0)
+			goto ERR;
+		if( data )
+			printf("*** M_read     channel %ld %ld torn reads\n", chan, data );
+	}/*for*/
+
 	if( hwRev >= M47_HW_REV_2 ) {
 		printf("\nChecking Get/Set States for HW-Revision %04x\n", hwRev );
 		/*------------------------------------------+
@@ -341,6 +349,11 @@ static int _m47_test (char* devName)
 
 	} /* if */
 
+	/*------------------------------------------+
+    |  interrupt driven FIFO read               |
+    +------------------------------------------*/
+	if( FifoTest( fd ) )
+		goto ERR;
 
 	printf("\n close path");
 	M_close (fd);
@@ -359,6 +372,88 @@ ERR:
 }
 
 
+/********************************* FifoTest *********************************
+ *
+ *  Description: Check interrupt driven M47_BLKRD_FIFO reads of channel 0
+ *
+ *               Enables the simulated frame-complete interrupt (requires
+ *               IRQ_SIM_PERIOD in the descriptor), drains the ring buffer several times
+ *               and checks that the sequence numbers are contiguous.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: fd		path
+ *  Output.....: return	success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+static int FifoTest(MDIS_PATH fd)
+{
+	M47_SAMPLE smp[16];
+	int32 n, i, loop, irqCount, overrun;
+	u_int32 expSeq = 0;
+	int first = 1;
+
+	printf("\nChecking interrupt driven FIFO read\n");
+
+	if ((M_setstat(fd, M_MK_CH_CURRENT, 0)) < 0) {
+		PrintError("setstat M_MK_CH_CURRENT");
+		return( 1 );
+	}
+	if (M_setstat(fd, M47_BLKRD_MODE, M47_BLKRD_FIFO) < 0) {
+		PrintError("setstat M47_BLKRD_MODE");
+		return( 1 );
+	}
+	if (M_setstat(fd, M47_READ_TIMEOUT, 1000) < 0 ||
+		M_setstat(fd, M47_FIFO_OVERRUN, 0) < 0 ||
+		M_setstat(fd, M47_FIFO_FLUSH, 0) < 0 ||
+		M_setstat(fd, M_LL_IRQ_COUNT, 0) < 0) {
+		PrintError("setstat");
+		return( 1 );
+	}
+	if (M_setstat(fd, M_MK_IRQ_ENABLE, 1) < 0) {
+		PrintError("setstat M_MK_IRQ_ENABLE (IRQ_SIM_PERIOD set?)");
+		return( 1 );
+	}
+
+	for( loop = 0; loop < 10; loop++ ) {
+		if ((n = M_getblock(fd, (u_int8*)smp, sizeof(smp))) < 0) {
+			PrintError("getblock (FIFO)");
+			goto ABORT;
+		}
+		n /= sizeof(M47_SAMPLE);
+
+		for( i = 0; i < n; i++ ) {
+			if( !first && smp[i].seq != expSeq )
+				printf("*** FIFO sequence %ld expected, got %ld\n",
+					   expSeq, smp[i].seq);
+			first = 0;
+			expSeq = smp[i].seq + 1;
+		}
+		printf("     %2ld samples, last %08lX\n", n,
+			   n ? smp[n-1].value : 0);
+	}
+
+	if (M_getstat(fd, M_LL_IRQ_COUNT, &irqCount) < 0 ||
+		M_getstat(fd, M47_FIFO_OVERRUN, &overrun) < 0) {
+		PrintError("getstat");
+		goto ABORT;
+	}
+	printf("Interrupts: %ld  overruns: %ld\n", irqCount, overrun);
+
+	M_setstat(fd, M_MK_IRQ_ENABLE, 0);
+	M_setstat(fd, M47_BLKRD_MODE, M47_BLKRD_SNAPSHOT);
+
+	if( irqCount == 0 ) {
+		printf("*** ERROR no interrupt (IRQ_SIM_PERIOD set?)\n");
+		return( 1 );
+	}
+	return( 0 );
+
+ABORT:
+	M_setstat(fd, M_MK_IRQ_ENABLE, 0);
+	M_setstat(fd, M47_BLKRD_MODE, M47_BLKRD_SNAPSHOT);
+	return( 1 );
+}
+
 /********************************* PrintError *******************************
  *
  *  Description: Print MDIS error message
@@ -55,6 +55,7 @@ static const char IdentString[]=MENT_XSTR(MAK_REVISION);
 +--------------------------------------*/
 #define M47_MAX_CH   4
 #define M47_HW_REV_2 0x0200
+#define READY_WAIT_MS 5000		/* max. wait for deferred init */
 
 /*--------------------------------------+
 |   TYPDEFS                             |
@@ -76,6 +77,7 @@ static const char IdentString[]=MENT_XSTR(MAK_REVISION);
 +--------------------------------------*/
 static int _m47_tool( char *devName, int32 ch );
 static void PrintError(char *info);
+static void PrintInitStat(MDIS_PATH path);
 static int32 GetValue(int32 def);
 
 
@@ -130,14 +132,21 @@ static int _m47_tool( char *devName, int32 ch )
 {
 	MDIS_PATH path;
 	int32   chan; 
-	u_int32 currVal[M47_MAX_CH];
+	u_int32 currVal[1 + M47_MAX_CH];	/* seq + data words */
+	u_int32 lastSeq = 0;
+	int32   readMask = 0;
+	int32   nWords, n;
+	u_int32 cycle;
 	char    *device;
 	int i;
 	int32   hwRev;
 	int32   sensEncoding = 0;
 	int32   dataWidth    = 32;
 	int32   baudrate     = 3;
-	u_int32 dummy[M47_MAX_CH];
+	int32   gen;
+	int32   ready;
+	M47_CONFIG cfg;
+	M_SG_BLOCK blk;
 
 	device = devName;
 	chan = ch;
@@ -152,6 +161,22 @@ static int _m47_tool( char *devName, int32 ch )
 		return(1);
 	}
 
+	/* wait for deferred init (INIT_DEFERRED) */
+	for (i = 0; i < READY_WAIT_MS / 10; i++) {
+		if (M_getstat(path, M47_READY, &ready) < 0)
+			goto abort;
+		if (ready)
+			break;
+		UOS_Delay(10);
+	}
+
+	if (!ready) {
+		printf("*** device not ready after %d ms\n", READY_WAIT_MS);
+		goto abort;
+	}
+
+	PrintInitStat(path);
+
 	/*-------------------------------------+
 	|  initialization of SSI-Transmission  |
 	+-------------------------------------*/
@@ -225,71 +250,79 @@ static int _m47_tool( char *devName, int32 ch )
 			} while( baudrate > 3 );
 
 			printf("\n");
-				
-			/* set current channel*/
-			if ((M_setstat(path, M_MK_CH_CURRENT, i)) < 0) {
-				PrintError("setstat M_MK_CH_CURRENT");
-				goto abort;
-			}
-			/* set data width for current channel of SSI sensor */
-			if (M_setstat(path, M47_DATA_WIDTH_CH, dataWidth) < 0) {
-				PrintError("setstat M47_DATA_WIDTH_CH");
-				goto abort;
-			}
-			/* set transmission mode of current channel */
-			if (M_setstat(path, M47_TRANS_MODE_CH, sensEncoding) < 0) {
-				PrintError("setstat M47_TRANS_MODE_CH");
-				goto abort;
-			}
-			/* set baudrate for current channel of SSI device */
-			if (M_setstat(path, M47_BAUDRATE_CH, baudrate) < 0) {
-				PrintError("setstat M47_BAUDRATE_CH");
-				goto abort;
-			}
+
+			cfg.ch[i].dataWidth = dataWidth;
+			cfg.ch[i].transMode = sensEncoding;
+			cfg.ch[i].baudRate  = baudrate;
 						
 		} /* for */
+
+		/* configure all channels at once */
+		blk.size = sizeof(cfg);
+		blk.data = (void*)&cfg;
+		if (M_setstat(path, M47_BLK_CONFIG, (INT32_OR_64)&blk) < 0) {
+			PrintError("setstat M47_BLK_CONFIG");
+			goto abort;
+		}
 		
 	} /* else */
 
-	/* wait for configuration to take effect */
-	UOS_MikroDelay( 1600 );
-	
-	/* perform dummy read from all channels to initialize buffer register */
-	if (M_getblock( path, (u_int8*) dummy, M47_MAX_CH * sizeof (u_int32)) < 0){
-		PrintError("getblock");
+	/* wait for the first frame with the new configuration */
+	for (i = 0; i < M47_MAX_CH; i++) {
+		if ((M_setstat(path, M_MK_CH_CURRENT, i)) < 0) {
+			PrintError("setstat M_MK_CH_CURRENT");
+			goto abort;
+		}
+		if (M_getstat(path, M47_WAIT_VALID, &gen) < 0)
+			printf("CH%d: no valid data (sensor connected?)\n", i);
+		else
+			readMask |= 1 << i;
+	}
+
+	if (!readMask) {
+		printf("*** no channel delivers data\n");
 		goto abort;
 	}
 
 	/*------------------------------------+
 	|  read value from SSI input channel  |
 	+-------------------------------------*/
-	printf("\nReading CH0 - CH3 cyclically\n");
+	printf("\nReading channel mask 0x%lx cyclically\n", readMask);
 	printf("\nPress ESC to Stop\n\n\n");
 
+	/* one M_getblock per cycle reads a new frame of each valid channel */
+	if ((M_setstat(path, M47_READ_MASK, readMask)) < 0 ||
+		(M_setstat(path, M47_BLKRD_MODE, M47_BLKRD_VECTOR)) < 0) {
+		PrintError("setstat M47_BLKRD_VECTOR");
+		goto abort;
+	}
 	
-	while (UOS_KeyPressed() != 27 /* ESC */) {
+	/* one sample: seq + data word of each channel */
+	for (i = 0, nWords = 1; i < M47_MAX_CH; i++)
+		if (readMask & (1 << i))
+			nWords++;
 
-		for (i = 0; i < 4; i++) {		
+	for (cycle = 0; UOS_KeyPressed() != 27 /* ESC */; cycle++) {
 
-			/* channel number */
-			if ((M_setstat(path, M_MK_CH_CURRENT, i)) < 0) {
-				PrintError("setstat M_MK_CH_CURRENT");
-				goto abort;
-			}
-			
-			/* read value */
-			if (M_read(path, (int32*)&currVal[i]) < 0) {
-				PrintError("read");
-				goto abort;
-			}
-	
-		} /* for */
+		/* read values */
+		if (M_getblock(path, (u_int8*)currVal,
+					   nWords * sizeof(u_int32)) < 0) {
+			PrintError("getblock");
+			goto abort;
+		}
+
+		/* each sample must hold new frames */
+		if (cycle && currVal[0] == lastSeq)
+			printf("\n*** sample %08lX repeated\n", currVal[0]);
+		lastSeq = currVal[0];
 
 		/* print readen values */
-		printf("CH0 = %08lX CH1 = %08lX CH2 = %08lX CH3 = %08lX", 
-		currVal[0], currVal[1], currVal[2], currVal[3]);
+		printf("seq = %08lX", currVal[0]);
+		for (i = 0, n = 1; i < M47_MAX_CH; i++)
+			if (readMask & (1 << i))
+				printf(" CH%d = %08lX", i, currVal[n++]);
 		/* clear line */
-		for( i = 0; i < 60; i++ )
+		for( i = 0; i < 80; i++ )
 			printf("\b");
 
 	} /* while */
@@ -345,6 +378,42 @@ static int32 GetValue(int32 def)
 	return val;
 }
 
+/******************************* PrintInitStat ******************************
+ *
+ *  Description: Print duration and register accesses of the driver's
+ *               init phases
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: path	device path
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void PrintInitStat(MDIS_PATH path)
+{
+	static const char *phase[M47_INIT_PHASES] =
+		{ "descriptor", "ID PROM", "flex load", "registers", "start" };
+	M47_INITSTAT stat;
+	M_SG_BLOCK blk;
+	u_int32 sumUs = 0;
+	int i;
+
+	blk.size = sizeof(stat);
+	blk.data = (void*)&stat;
+	if (M_getstat(path, M47_BLK_INITSTAT, (int32*)&blk) < 0) {
+		PrintError("getstat M47_BLK_INITSTAT");
+		return;
+	}
+
+	printf("\nInit phases (resolution %lu us%s):\n", stat.resUs,
+		   stat.deferred ? ", deferred" : "");
+	for (i = 0; i < M47_INIT_PHASES; i++) {
+		printf("  %-10s %8lu us %8lu accesses%s\n", phase[i], stat.us[i],
+			   stat.access[i], i == M47_INIT_ID ? " (words)" : "");
+		sumUs += stat.us[i];
+	}
+	printf("  %-10s %8lu us\n", "total", sumUs);
+}
+
 /********************************* PrintError *******************************
  *
  *  Description: Print MDIS error message
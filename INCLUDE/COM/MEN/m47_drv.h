@@ -8,7 +8,7 @@
  *               - M47 specific status codes
  *               - M47 function prototypes
  *
- *     Switches: _ONE_NAMESPACE_PER_DRIVER_
+ *     Switches: _ONE_NAMESPACE_PER_DRIVER_, MAC_BYTESWAP, M47_FAST
  *               _LL_DRV_
  *
  *
@@ -39,10 +39,81 @@
 #endif
 
 
+/* init phases of M47_INITSTAT (M47_BLK_INITSTAT) */
+#define M47_INIT_DESC          0				/* init phase: descriptor, memory */
+#define M47_INIT_ID            1				/* init phase: ID PROM read/check */
+#define M47_INIT_FLEX          2				/* init phase: PLD bitstream load */
+#define M47_INIT_HW            3				/* init phase: registers, data RAM */
+#define M47_INIT_START         4				/* init phase: start of alarms */
+#define M47_INIT_PHASES        5				/* number of init phases */
+
+
 /*-----------------------------------------+
 |  TYPEDEFS                                |
 +-----------------------------------------*/
-/* none */
+/* sample record returned by M_getblock in M47_BLKRD_FIFO mode */
+typedef struct {
+	u_int32 seq;			/* per-channel sequence number */
+	u_int32 value;			/* SSI data word */
+} M47_SAMPLE;
+
+/* sample record returned by M_getblock in M47_BLKRD_FIFO_TS mode */
+typedef struct {
+	u_int32 seq;			/* per-channel sequence number */
+	u_int32 value;			/* SSI data word */
+	u_int64 stamp;			/* time of acquisition [us], monotonic */
+	u_int64 latch;			/* estimated sensor latch time [us] */
+} M47_TSAMPLE;
+
+/* module configuration for M47_BLK_CONFIG */
+typedef struct {
+	struct {
+		u_int32 baudRate;	/* baud rate (M47_BAUD_xxx) */
+		u_int32 dataWidth;	/* data width (0..32) */
+		u_int32 transMode;	/* transmission mode (M47_TRANS_MODE_xxx) */
+	} ch[4];				/* channels 0..3 */
+} M47_CONFIG;
+
+/* channel motion returned by M47_BLK_MOTION */
+typedef struct {
+	int64   pos;			/* continuous position [counts] */
+	int64   vel;			/* velocity [1/2^M47_MOTION_FRAC counts/s] */
+	int64   acc;			/* acceleration [1/2^M47_MOTION_FRAC counts/s^2] */
+	u_int64 stamp;			/* time of last position update [us] */
+} M47_MOTION;
+
+/* header of the PLD bitstream passed with M47_BLK_FLEXLOAD */
+typedef struct {
+	u_int32 hash;			/* FNV-1a hash of the file (must match) */
+	u_int32 size;			/* size of the file [bytes] */
+	/* followed by the bitstream file (m47_<major>r<minor>.bin) */
+} M47_FLEXBLOB;
+
+/* snapshot returned by M_getblock in M47_BLKRD_COHERENT mode */
+typedef struct {
+	u_int32 value[4];		/* data word of channels 0..3 */
+	u_int32 skew;			/* register accesses between the d7..d0 */
+							/* reads of first and last channel */
+							/* (measure of the channel skew) */
+	u_int32 retries;		/* re-reads due to torn data words */
+							/* (max. M47_SNAP_RETRY_MAX) */
+} M47_SNAPSHOT;
+
+/* sample returned by M_getblock in M47_BLKRD_FLAGGED mode (one per CH) */
+typedef struct {
+	u_int32 value;			/* SSI data word */
+	u_int32 flags;			/* M47_SMP_xxx */
+} M47_FSAMPLE;
+
+/* init phase statistics returned by M47_BLK_INITSTAT */
+typedef struct {
+	u_int32 us[M47_INIT_PHASES];		/* duration per phase M47_INIT_xxx [us] */
+	u_int32 access[M47_INIT_PHASES];	/* register accesses per phase */
+							/* (M47_INIT_ID: ID PROM words read) */
+	u_int32 resUs;			/* time resolution [us] */
+	u_int32 deferred;		/* FLEX phase done by INIT_DEFERRED alarm, */
+							/* HW phase by first call after it */
+} M47_INITSTAT;
 
 /*-----------------------------------------+
 |  DEFINES                                 |
@@ -58,6 +129,34 @@
 #define M47_TRANS_MODE_CH      M_DEV_OF+0x07	/* G,S: Transmission mode (gray or binery) */
 												/*      for specific channel */
 #define M47_HW_REV             M_DEV_OF+0x08	/* G:   HW revision of module */
+#define M47_BLKRD_MODE         M_DEV_OF+0x09	/* G,S: M_getblock mode (see below) */
+#define M47_SAMPLE_PERIOD      M_DEV_OF+0x0a	/* G,S: background sampling period [ms] */
+#define M47_FIFO_COUNT         M_DEV_OF+0x0b	/* G:   samples buffered for specific CH */
+#define M47_FIFO_OVERRUN       M_DEV_OF+0x0c	/* G,S: overrun counter for specific CH */
+#define M47_FIFO_FLUSH         M_DEV_OF+0x0d	/* S:   discard all buffered samples */
+#define M47_READ_TIMEOUT       M_DEV_OF+0x0e	/* G,S: M47_BLKRD_FIFO read timeout [ms] */
+#define M47_CONSISTENT_READ    M_DEV_OF+0x0f	/* G,S: re-read torn data words (0/1) */
+#define M47_TEAR_COUNT         M_DEV_OF+0x10	/* G,S: torn data words for specific CH */
+#define M47_POS64_RESET        M_DEV_OF+0x11	/* S:   restart unwrapping for specific CH */
+#define M47_VELOCITY           M_DEV_OF+0x12	/* G:   velocity of specific CH */
+#define M47_ACCEL              M_DEV_OF+0x13	/* G:   acceleration of specific CH */
+#define M47_MOTION_WINDOW      M_DEV_OF+0x14	/* G,S: motion filter window [samples] */
+#define M47_CONNECT_PERIOD     M_DEV_OF+0x15	/* G,S: connection monitor period [ms] */
+#define M47_CONNECT_AGE        M_DEV_OF+0x16	/* G:   age of connection state [ms] */
+#define M47_CFG_GEN            M_DEV_OF+0x17	/* G:   config generation of specific CH */
+#define M47_WAIT_VALID         M_DEV_OF+0x18	/* G:   wait for first frame after config */
+												/*      change, returns config generation */
+#define M47_VALID_TIMEOUT      M_DEV_OF+0x19	/* G,S: M47_WAIT_VALID timeout [ms] */
+#define M47_FLEX_HASH          M_DEV_OF+0x1a	/* G:   hash of loaded PLD bitstream */
+												/*      (0 = unknown) */
+#define M47_READY              M_DEV_OF+0x1b	/* G:   hardware initialized */
+												/*      (see INIT_DEFERRED) */
+#define M47_GLITCH_LIMIT       M_DEV_OF+0x1c	/* G,S: glitch filter velocity limit for */
+												/*      specific CH [counts/s] (0 = off), */
+												/*      positions and motion only */
+#define M47_GLITCH_COUNT       M_DEV_OF+0x1d	/* G,S: rejected data words for specific CH */
+#define M47_READ_MASK          M_DEV_OF+0x1e	/* G,S: M47_BLKRD_VECTOR channels */
+												/*      (bit n = CH n) */
 
 /* M47 specific value coding (STD) */			
 #define M47_BAUD_500           0x0000			/* Baudrate 500 kbaud */
@@ -66,10 +165,40 @@
 #define M47_BAUD_62_5          0x0003			/* Baudrate 62.5 kbaud */
 #define M47_TRANS_MODE_GRAY    0x0000			/* Transmission mode gray-code */
 #define M47_TRANS_MODE_BIN     0x0001			/* Transmission mode binery-code */
+#define M47_BLKRD_SNAPSHOT     0x0000			/* M_getblock: one value per channel */
+#define M47_BLKRD_FIFO         0x0001			/* M_getblock: M47_SAMPLE records of */
+												/*             specific channel */
+#define M47_BLKRD_FIFO_TS      0x0002			/* M_getblock: M47_TSAMPLE records of */
+												/*             specific channel */
+#define M47_BLKRD_POS64        0x0003			/* M_getblock: continuous position per */
+												/*             channel (int64) */
+#define M47_BLKRD_COHERENT     0x0004			/* M_getblock: M47_SNAPSHOT of all */
+												/*             channels */
+#define M47_SNAP_RETRY_MAX     3				/* max. M47_SNAPSHOT re-reads, each */
+												/* <= 28 accesses with spin lock held */
+#define M47_BLKRD_FLAGGED      0x0005			/* M_getblock: M47_FSAMPLE per channel */
+#define M47_BLKRD_VECTOR       0x0006			/* M_getblock: consecutive samples of */
+												/*             M47_READ_MASK channels, */
+												/*             each: seq + data words */
+#define M47_SMP_FRESH          0x0001			/* new frame since last flagged read */
+#define M47_SMP_VALID          0x0002			/* frame with current config seen */
+#define M47_SMP_STALE          0x0004			/* no frame for M47_STALE_FRAMES */
+												/* frame times */
+#define M47_SMP_DISCONN        0x0008			/* no frame for M47_VALID_TIMEOUT */
+#define M47_STALE_FRAMES       4				/* see M47_SMP_STALE */
+#define M47_MOTION_FRAC        8				/* fractional bits of velocity and */
+												/* acceleration values */
 
 
 /* M47 specific status codes (BLK)	*/			/* S,G: S=setstat, G=getstat */
-/*#define M47_BLK_XXX       M_DEV_BLK_OF+0x00 *//* G,S: xxx */
+#define M47_BLK_POS64          M_DEV_BLK_OF+0x00	/* G,S: continuous positions (int64) */
+												/*      G: channels 0..3, S: preset */
+												/*      for specific channel */
+#define M47_BLK_MOTION         M_DEV_BLK_OF+0x01	/* G:   M47_MOTION of channels 0..3 */
+#define M47_BLK_CONFIG         M_DEV_BLK_OF+0x02	/* G,S: M47_CONFIG of all channels */
+#define M47_BLK_FLEXLOAD       M_DEV_BLK_OF+0x03	/* S:   load PLD bitstream */
+												/*      (M47_FLEXBLOB + file) */
+#define M47_BLK_INITSTAT       M_DEV_BLK_OF+0x04	/* G:   M47_INITSTAT of M47_Init */
 
 /*-----------------------------------------+
 |  PROTOTYPES                              |
@@ -77,7 +206,11 @@
 #ifdef _LL_DRV_
 # ifndef _ONE_NAMESPACE_PER_DRIVER_
 #  ifndef MAC_BYTESWAP
+#   ifndef M47_FAST
     extern void M47_GetEntry( LL_ENTRY* drvP );
+#   else
+    extern void M47_FAST_GetEntry( LL_ENTRY* drvP );
+#   endif /* M47_FAST */
 #  else
     extern void M47_SW_GetEntry( LL_ENTRY* drvP );
 #  endif /* MAC_BYTESWAP */